@@ -0,0 +1,95 @@
+// Code size and throughput of the templated parser (json::parse) against the table driven one (json::parse_planned).
+// Built twice by CMake, once per engine, so the executable sizes can be compared directly:
+//   plan_bench_templated / plan_bench_planned [iterations]
+// BENCH_TYPES (default 64) controls how many distinct RPOCO2 types are generated.
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_plan.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+#ifndef BENCH_TYPES
+#define BENCH_TYPES 64
+#endif
+
+#ifndef BENCH_PLANNED
+#define BENCH_PLANNED 0
+#endif
+
+struct Inner {
+	int id;
+	float weight;
+	char tag[12];
+	RPOCO2(&Inner::id, &Inner::weight, &Inner::tag);
+};
+
+// every K is a distinct type with its own parser instantiation (or parse plan)
+template<int K>
+struct Part {
+	int id;
+	char label[8];
+	RPOCO2(&Part::id, &Part::label);
+};
+
+template<int K>
+struct Gen {
+	int count;
+	double price;
+	bool active;
+	char name[24];
+	Inner inner;
+	std::vector<int> values;
+	std::string note;
+	std::vector<Part<K>> parts;
+	RPOCO2(&Gen::count, &Gen::price, &Gen::active, &Gen::name, &Gen::inner, &Gen::values, &Gen::note, &Gen::parts);
+};
+
+static const char doc[] = R"({ "count": 1234, "price": 99.25, "active": true, "name": "generated member",
+	"inner": { "id": 42, "weight": 0.5, "tag": "abcdef" }, "values": [1, 2, 3, 4, 5, 6, 7, 8],
+	"unknown": { "skipped": [1, 2, 3] }, "note": "a note long enough to leave the small string buffer",
+	"parts": [{ "id": 1, "label": "first" }, { "id": 2, "label": "second" }] })";
+
+template<int K>
+static bool parse_one(const char* src, int len) {
+	Gen<K> g{};
+#if BENCH_PLANNED
+	return rpoco2::json::parse_planned(g, src, len);
+#else
+	return rpoco2::json::parse(g, src, len);
+#endif
+}
+
+template<int ... K>
+static bool parse_all(const char* src, int len, std::integer_sequence<int, K...>) {
+	return (parse_one<K>(src, len) && ...);
+}
+
+int main(int argc, char** argv) {
+	int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+	int len = (int)sizeof(doc) - 1;
+
+	struct stat st;
+	long long exe_size = stat(argv[0], &st) == 0 ? (long long)st.st_size : -1;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		if (!parse_all(doc, len, std::make_integer_sequence<int, BENCH_TYPES>())) {
+			fprintf(stderr, "parse failed\n");
+			return 1;
+		}
+	}
+	double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double bytes = (double)len * BENCH_TYPES * iterations;
+
+	printf("engine:     %s\n", BENCH_PLANNED ? "parse_planned" : "parse");
+	printf("types:      %d\n", BENCH_TYPES);
+	printf("executable: %lld bytes\n", exe_size);
+	printf("throughput: %.1f MB/s (%.0f docs/s)\n", bytes / secs / 1e6, (double)BENCH_TYPES * iterations / secs);
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Throughput of string scanning with utf-8 validation on ascii, latin, cjk and emoji payloads:
+//   two-pass: scan_string followed by utf8_validate (scalar decode of every multibyte sequence)
+//   one-pass: scan_string_utf8 (lookup table validation folded into the scan, needs an SSSE3 build)
+//   parse:    json::parse of the payload as a std::string
+//   utf8_bench [megabytes]
+
+#include <rpoco2/json_std.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace rpoco2::json;
+
+static std::string payload(const char* unit, size_t bytes) {
+	std::string s;
+	while (s.size() < bytes)
+		s += unit;
+	return s;
+}
+
+template<class F>
+static double measure(const std::string& s, int reps, F&& fn) {
+	size_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < reps; i++)
+		sink += fn(s);
+	double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (sink == 1)
+		printf(" ");
+	return (double)s.size() * reps / secs / 1e9;
+}
+
+int main(int argc, char** argv) {
+	size_t mb = argc > 1 ? atoi(argv[1]) : 256;
+	const size_t size = 64 * 1024;
+	int reps = (int)(mb * 1024 * 1024 / size);
+
+	struct {
+		const char* name;
+		const char* unit;
+	} sets[] = {
+		{ "ascii", "The quick brown fox jumps over the lazy dog. " },
+		{ "latin", "Les \xc3\xa9l\xc3\xa8ves \xc3\xa0 l'\xc3\xa9" "cole, d\xc3\xa9j\xc3\xa0 fa\xc3\xa7onn\xc3\xa9s. " },
+		{ "cjk", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x81\xa7\xe3\x81\x99\xe3\x80\x82" },
+		{ "emoji", "\xf0\x9f\x98\x80\xf0\x9f\x8e\x89 ok \xf0\x9f\x91\x8d\xf0\x9f\x9a\x80" },
+	};
+
+	printf("ssse3: %s\n", RPOCO2_SSSE3 ? "yes" : "no");
+	printf("%-8s %12s %12s %12s\n", "payload", "two-pass", "one-pass", "parse");
+	for (auto& set : sets) {
+		std::string s = payload(set.unit, size);
+		std::string doc = "\"" + s + "\"";
+
+		double two = measure(s, reps, [](const std::string& s) {
+			size_t bad = 0;
+			size_t n = impl::scan_string(s.data(), s.data() + s.size());
+			return impl::utf8_validate(s.data(), n, bad);
+		});
+		double one = measure(s, reps, [](const std::string& s) {
+			size_t valid = 0, bad = 0;
+			size_t n = impl::scan_string_utf8(s.data(), s.data() + s.size(), valid);
+			return valid == n ? n : valid + impl::utf8_validate(s.data() + valid, n - valid, bad);
+		});
+		std::string out;
+		double parsed = measure(doc, reps, [&out](const std::string& d) {
+			parse(out, d.data(), (int)d.size());
+			return out.size();
+		});
+		printf("%-8s %9.2f GB/s %9.2f GB/s %9.2f GB/s\n", set.name, two, one, parsed);
+	}
+	return 0;
+}
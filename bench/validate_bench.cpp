@@ -0,0 +1,89 @@
+// Throughput of json::validate and json::minify against the scalar scan that locates errors (impl::scan_document, with
+// and without collecting its output) on token dense, string heavy, pretty printed and multibyte documents of about 4 MB:
+//   validate_bench [megabytes per round]
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_validate.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace rpoco2::json;
+
+static std::string document(const char* item, const char* sep, size_t bytes) {
+	std::string s = "[";
+	while (s.size() < bytes) {
+		if (s.size() > 1)
+			s += sep;
+		s += item;
+	}
+	return s + "]";
+}
+
+// best of 5 rounds, shared machines are noisy
+template<class F>
+static double measure(const std::string& s, int reps, F&& fn) {
+	double best = 0;
+	for (int round = 0; round < 5; round++) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < reps; i++) {
+			if (!fn(s)) {
+				fprintf(stderr, "invalid document\n");
+				exit(1);
+			}
+		}
+		double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double rate = (double)s.size() * reps / secs / 1e9;
+		best = rate > best ? rate : best;
+	}
+	return best;
+}
+
+int main(int argc, char** argv) {
+	size_t mb = argc > 1 ? atoi(argv[1]) : 128;
+	const size_t size = 4 * 1024 * 1024;
+	int reps = (int)(mb * 1024 * 1024 / size);
+
+	struct {
+		const char* name;
+		const char* item;
+		const char* sep;
+	} sets[] = {
+		{ "tokens", "{\"id\":1234,\"x\":-0.25,\"y\":1e3,\"ok\":true,\"tag\":null,\"v\":[1,2,3,4]}", "," },
+		{ "strings", "{\"name\":\"The quick brown fox jumps over the lazy dog\",\"text\":\"a longer description with an \\\"escaped\\\" quote and a \\u00e9 escape in it\"}", "," },
+		{ "pretty", "{\n        \"id\": 1234,\n        \"name\": \"pretty printed\",\n        \"values\": [\n            1,\n            2\n        ]\n    }", ",\n    " },
+		{ "utf8", "{\"name\":\"Les \xc3\xa9l\xc3\xa8ves \xc3\xa0 l'\xc3\xa9" "cole\",\"jp\":\"\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\",\"e\":\"\xf0\x9f\x98\x80\xf0\x9f\x8e\x89\"}", "," },
+	};
+
+	// the structural pass needs SSE2, SSSE3 speeds up the utf-8 checks of the scalar string scan
+	printf("sse2: %s, ssse3: %s\n", RPOCO2_SSE2 ? "yes" : "no", RPOCO2_SSSE3 ? "yes" : "no");
+	printf("%-8s %12s %12s %12s %12s\n", "document", "scalar", "validate", "scalar min", "minify");
+	for (auto& set : sets) {
+		std::string doc = document(set.item, set.sep, size);
+
+		double scalar = measure(doc, reps, [](const std::string& d) {
+			auto sink = [](const char*, size_t) {};
+			return (bool)impl::scan_document(d.data(), d.size(), utf8_mode::reject, sink);
+		});
+		double valid = measure(doc, reps, [](const std::string& d) {
+			return (bool)validate(d.data(), d.size());
+		});
+		std::string out;
+		double scalar_min = measure(doc, reps, [&out](const std::string& d) {
+			out.clear();
+			auto sink = [&out](const char* p, size_t n) {
+				if (n)
+					out.append(p, n);
+			};
+			return (bool)impl::scan_document(d.data(), d.size(), utf8_mode::reject, sink);
+		});
+		double minified = measure(doc, reps, [&out](const std::string& d) {
+			out.clear();
+			return (bool)minify(d.data(), d.size(), out);
+		});
+		printf("%-8s %9.2f GB/s %9.2f GB/s %9.2f GB/s %9.2f GB/s\n", set.name, scalar, valid, scalar_min, minified);
+	}
+	return 0;
+}
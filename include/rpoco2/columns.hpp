@@ -0,0 +1,120 @@
+#pragma once
+
+#include "rpoco.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace rpoco2 {
+
+	namespace impl2 {
+		// arrays can't be vector elements so array members are stored as std::array
+		template<class M>
+		struct column_value {
+			using type = M;
+		};
+		template<class M, std::size_t L>
+		struct column_value<M[L]> {
+			using type = std::array<M, L>;
+		};
+
+		template<class T, class IS>
+		struct column_tuple;
+		template<class T, std::size_t ... I>
+		struct column_tuple<T, std::index_sequence<I...>> {
+			using TI = std::remove_const_t<decltype(tinfo<T>)>;
+			using type = std::tuple<std::vector<typename column_value<typename TI::template member_type<I>>::type>...>;
+		};
+	}
+
+	// struct-of-arrays storage for an RPOCO2 type, one contiguous column per declared member
+	template<class T>
+	class columns {
+		using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+		using IS = std::make_index_sequence<TI::count>;
+
+		typename impl2::column_tuple<T, IS>::type cols;
+		std::size_t rows = 0;
+
+		template<auto K>
+		static constexpr std::size_t index() {
+			if constexpr (std::is_integral_v<decltype(K)>) {
+				static_assert(0 <= K && K < TI::count, "column index out of range");
+				return K;
+			} else {
+				constexpr int idx = impl2::member_index<T, K>();
+				static_assert(idx >= 0, "member is not declared in the RPOCO2 list");
+				return idx;
+			}
+		}
+
+		template<std::size_t ... I>
+		void push_impl(const T& v, std::index_sequence<I...>) {
+			(push_one(std::get<I>(cols), v.*(impl2::tinfo<T>.template member_ptr<I>())), ...);
+		}
+		template<std::size_t ... I>
+		void row_impl(T& v, std::size_t idx, std::index_sequence<I...>) const {
+			(assign(v.*(impl2::tinfo<T>.template member_ptr<I>()), std::get<I>(cols)[idx]), ...);
+		}
+
+		template<class C, class S>
+		static void push_one(C& c, const S& s) {
+			if constexpr (std::is_array_v<S>) {
+				c.emplace_back();
+				std::copy(std::begin(s), std::end(s), std::begin(c.back()));
+			} else {
+				c.push_back(s);
+			}
+		}
+		template<class D, class S>
+		static void assign(D& d, const S& s) {
+			if constexpr (std::is_array_v<D> || std::is_array_v<S>)
+				std::copy(std::begin(s), std::end(s), std::begin(d));
+			else
+				d = s;
+		}
+	public:
+		// column by declaration index or member pointer, ie: cols.column<0>() or cols.column<&T::price>()
+		template<auto K>
+		auto& column() {
+			return std::get<index<K>()>(cols);
+		}
+		template<auto K>
+		const auto& column() const {
+			return std::get<index<K>()>(cols);
+		}
+
+		std::size_t size() const {
+			return rows;
+		}
+
+		void clear() {
+			std::apply([](auto& ... c) { (c.clear(), ...); }, cols);
+			rows = 0;
+		}
+
+		void reserve(std::size_t n) {
+			std::apply([n](auto& ... c) { (c.reserve(n), ...); }, cols);
+		}
+
+		// appends a row holding the members of a default constructed T (so default member initializers apply)
+		// and returns its index
+		std::size_t emplace_row() {
+			static const T seed{};
+			push_impl(seed, IS());
+			return rows++;
+		}
+
+		void push_back(const T& v) {
+			push_impl(v, IS());
+			rows++;
+		}
+
+		// gathers a row back into a T
+		T row(std::size_t idx) const {
+			T v{};
+			row_impl(v, idx, IS());
+			return v;
+		}
+	};
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "rpoco.hpp"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Member-wise conversion between RPOCO2 types, ie: auto order = rpoco2::convert<Order>(orderDto);
+// Members are matched by name at compile time, matching members are copied (or moved from an rvalue source),
+// nested RPOCO2 types and containers of them are converted recursively.
+
+namespace rpoco2 {
+
+	enum class convert_mode {
+		strict=0,   // every destination member needs a convertible source member of the same name (static_assert),
+		            // arithmetic conversions that narrow (ie: double to int, int64_t to int8_t) don't count as convertible
+		lenient     // destination members without a convertible source are left as they are, narrowing is allowed
+	};
+
+	namespace impl2 {
+		template<class T>
+		using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+		// elements of an rvalue source are moved, otherwise copied
+		template<class SS, class E>
+		constexpr decltype(auto) forward_like(E& e) {
+			if constexpr (std::is_lvalue_reference_v<SS>)
+				return static_cast<const E&>(e);
+			else
+				return std::move(e);
+		}
+		template<class SS, class E>
+		using forwarded_t = decltype(forward_like<SS>(std::declval<E&>()));
+
+		template<class T, template<class...> class TT>
+		struct is_instance : std::false_type {};
+		template<template<class...> class TT, class... A>
+		struct is_instance<TT<A...>, TT> : std::true_type {};
+
+		// container conversions, specialized below
+		template<class D, class S, class = void>
+		struct convert_ops {
+			template<convert_mode M>
+			static constexpr bool value = false;
+		};
+
+		// arithmetic conversions that brace initialization rejects
+		template<class D, class S, class = void>
+		struct brace_convertible : std::false_type {};
+		template<class D, class S>
+		struct brace_convertible<D, S, std::void_t<decltype(D{ std::declval<S>() })>> : std::true_type {};
+		template<class D, class S>
+		inline constexpr bool is_narrowing_v = std::is_arithmetic_v<D> && std::is_arithmetic_v<S> && !brace_convertible<D, S>::value;
+
+		enum class convert_how {
+			none=0,
+			assign,
+			members,
+			ops
+		};
+
+		// SS is the source type with its value category (const S& or S)
+		template<convert_mode M, class D, class SS>
+		constexpr convert_how how_to_convert() {
+			using S = remove_cvref_t<SS>;
+			if constexpr (std::is_assignable_v<D&, SS&&> && (std::is_same_v<D, S> || std::is_convertible_v<SS&&, D>)
+					&& (M == convert_mode::lenient || !is_narrowing_v<D, S>))
+				return convert_how::assign;
+			else if constexpr (is_rpoco_v<D> && is_rpoco_v<S>)
+				return convert_how::members;
+			else if constexpr (convert_ops<D, SS>::template value<M>)
+				return convert_how::ops;
+			else
+				return convert_how::none;
+		}
+		template<convert_mode M, class D, class SS>
+		inline constexpr bool can_convert_v = how_to_convert<M, D, SS>() != convert_how::none;
+
+		template<convert_mode M, class D, class SS>
+		void convert_members(D& d, SS&& s);
+
+		template<convert_mode M, class D, class SS>
+		void convert_value(D& d, SS&& s) {
+			constexpr convert_how how = how_to_convert<M, D, SS>();
+			if constexpr (how == convert_how::assign)
+				d = std::forward<SS>(s);
+			else if constexpr (how == convert_how::members)
+				convert_members<M>(d, std::forward<SS>(s));
+			else
+				convert_ops<D, SS>::template apply<M>(d, std::forward<SS>(s));
+		}
+
+		template<class T, class A, class SS>
+		struct convert_ops<std::vector<T, A>, SS, std::enable_if_t<is_instance<remove_cvref_t<SS>, std::vector>::value>> {
+			using E = typename remove_cvref_t<SS>::value_type;
+			template<convert_mode M>
+			static constexpr bool value = can_convert_v<M, T, forwarded_t<SS, E>>;
+			template<convert_mode M>
+			static void apply(std::vector<T, A>& d, SS&& s) {
+				d.clear();
+				d.reserve(s.size());
+				for (auto& e : s) {
+					d.emplace_back();
+					convert_value<M>(d.back(), forward_like<SS>(e));
+				}
+			}
+		};
+
+		// plain and std arrays of the same length
+		template<class T>
+		struct array_traits : std::false_type {};
+		template<class T, std::size_t L>
+		struct array_traits<T[L]> : std::true_type {
+			using elem = T;
+			static constexpr std::size_t size = L;
+		};
+		template<class T, std::size_t L>
+		struct array_traits<std::array<T, L>> : std::true_type {
+			using elem = T;
+			static constexpr std::size_t size = L;
+		};
+
+		template<class DA, class SS>
+		struct convert_ops<DA, SS, std::enable_if_t<array_traits<DA>::value && array_traits<remove_cvref_t<SS>>::value>> {
+			using S = remove_cvref_t<SS>;
+			template<convert_mode M>
+			static constexpr bool value = array_traits<DA>::size == array_traits<S>::size
+				&& can_convert_v<M, typename array_traits<DA>::elem, forwarded_t<SS, typename array_traits<S>::elem>>;
+			template<convert_mode M>
+			static void apply(DA& d, SS&& s) {
+				for (std::size_t i = 0; i < array_traits<DA>::size; i++)
+					convert_value<M>(d[i], forward_like<SS>(s[i]));
+			}
+		};
+
+		template<class K, class V, class C, class A, class SS>
+		struct convert_ops<std::map<K, V, C, A>, SS, std::enable_if_t<is_instance<remove_cvref_t<SS>, std::map>::value>> {
+			using S = remove_cvref_t<SS>;
+			template<convert_mode M>
+			static constexpr bool value = can_convert_v<M, K, const typename S::key_type&> && can_convert_v<M, V, forwarded_t<SS, typename S::mapped_type>>;
+			template<convert_mode M>
+			static void apply(std::map<K, V, C, A>& d, SS&& s) {
+				d.clear();
+				for (auto& kv : s) {
+					K key{};
+					convert_value<M>(key, kv.first);
+					convert_value<M>(d[std::move(key)], forward_like<SS>(kv.second));
+				}
+			}
+		};
+
+		template<class T, class SS>
+		struct convert_ops<std::optional<T>, SS, std::enable_if_t<is_instance<remove_cvref_t<SS>, std::optional>::value>> {
+			using U = typename remove_cvref_t<SS>::value_type;
+			template<convert_mode M>
+			static constexpr bool value = can_convert_v<M, T, forwarded_t<SS, U>>;
+			template<convert_mode M>
+			static void apply(std::optional<T>& d, SS&& s) {
+				if (!s) {
+					d.reset();
+					return;
+				}
+				convert_value<M>(d.emplace(), forward_like<SS>(*s));
+			}
+		};
+
+		// pointers to other types (or unique_ptr's from a const source) get a freshly converted pointee
+		template<class T, class SS>
+		struct convert_ops<std::shared_ptr<T>, SS, std::enable_if_t<is_instance<remove_cvref_t<SS>, std::shared_ptr>::value>> {
+			using U = typename remove_cvref_t<SS>::element_type;
+			template<convert_mode M>
+			static constexpr bool value = can_convert_v<M, T, const U&>;
+			template<convert_mode M>
+			static void apply(std::shared_ptr<T>& d, SS&& s) {
+				if (!s) {
+					d.reset();
+					return;
+				}
+				d = std::make_shared<T>();
+				convert_value<M>(*d, static_cast<const U&>(*s));
+			}
+		};
+		template<class T, class D, class SS>
+		struct convert_ops<std::unique_ptr<T, D>, SS, std::enable_if_t<is_instance<remove_cvref_t<SS>, std::unique_ptr>::value>> {
+			using U = typename remove_cvref_t<SS>::element_type;
+			template<convert_mode M>
+			static constexpr bool value = can_convert_v<M, T, forwarded_t<SS, U>>;
+			template<convert_mode M>
+			static void apply(std::unique_ptr<T, D>& d, SS&& s) {
+				if (!s) {
+					d.reset();
+					return;
+				}
+				// reset keeps the deleter d already has, make_unique would need D to be the default_delete
+				d.reset(new T());
+				convert_value<M>(*d, forward_like<SS>(*s));
+			}
+		};
+
+		template<convert_mode M, class D, class SS, std::size_t I>
+		void convert_member(D& d, SS& s) {
+			using S = remove_cvref_t<SS>;
+			using DM = typename remove_cvref_t<decltype(tinfo<D>)>::template member_type<I>;
+			constexpr std::string_view name = tinfo<D>.member_names()[I].name;
+			constexpr int J = tinfo<S>.find(name.data(), name.size());
+			if constexpr (J < 0) {
+				static_assert(M == convert_mode::lenient, "rpoco2::convert: destination member has no source member with the same name");
+			} else {
+				constexpr auto smp = tinfo<S>.template member_ptr<J>();
+				using SM = remove_cvref_t<decltype(s.*smp)>;
+				if constexpr (can_convert_v<M, DM, forwarded_t<SS, SM>>) {
+					convert_value<M>(d.*(tinfo<D>.template member_ptr<I>()), forward_like<SS>(s.*smp));
+				} else {
+					static_assert(M == convert_mode::lenient, "rpoco2::convert: member types can't be converted");
+				}
+			}
+		}
+
+		template<convert_mode M, class D, class SS, std::size_t ... I>
+		void convert_members_impl(D& d, SS& s, std::index_sequence<I...>) {
+			(convert_member<M, D, SS, I>(d, s), ...);
+		}
+
+		template<convert_mode M, class D, class SS>
+		void convert_members(D& d, SS&& s) {
+			convert_members_impl<M, D, SS>(d, s, std::make_index_sequence<remove_cvref_t<decltype(tinfo<D>)>::count>());
+		}
+	}
+
+	// converts src into an existing dst. In strict mode (the default) every member of dst needs a convertible source
+	// member or compilation fails, in lenient mode members of dst without one are left as they are
+	template<convert_mode M = convert_mode::strict, class Dst, class Src>
+	void convert_into(Dst& dst, Src&& src) {
+		static_assert(impl2::is_rpoco_v<Dst> && impl2::is_rpoco_v<impl2::remove_cvref_t<Src>>, "rpoco2::convert needs RPOCO2 types");
+		using SS = std::conditional_t<std::is_lvalue_reference_v<Src>, const impl2::remove_cvref_t<Src>&, impl2::remove_cvref_t<Src>>;
+		impl2::convert_members<M>(dst, static_cast<SS&&>(src));
+	}
+
+	// a new Dst converted from src, members are moved when src is an rvalue
+	template<class Dst, convert_mode M = convert_mode::strict, class Src>
+	Dst convert(Src&& src) {
+		Dst rv{};
+		convert_into<M>(rv, std::forward<Src>(src));
+		return rv;
+	}
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <string.h>
+
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Containers with inline storage and a fixed capacity, they never allocate.
+// Overflow policy: adding to a full container does nothing and reports failure (push_back/append return false,
+// emplace_back returns null), so parsing a document that doesn't fit fails instead of truncating data.
+// Constructing a fixed_string from a string that doesn't fit throws std::length_error.
+
+namespace rpoco2 {
+
+	// zero terminated string of up to N characters
+	template<size_t N>
+	class fixed_string {
+		char buf[N + 1] = {};
+		size_t len = 0;
+	public:
+		fixed_string() = default;
+		// throws std::length_error if sv doesn't fit, use assign() to check without exceptions
+		explicit fixed_string(std::string_view sv) {
+			if (!assign(sv))
+				throw std::length_error("fixed_string capacity exceeded");
+		}
+
+		static constexpr size_t capacity() {
+			return N;
+		}
+		size_t size() const {
+			return len;
+		}
+		bool empty() const {
+			return len == 0;
+		}
+		bool full() const {
+			return len == N;
+		}
+		const char* c_str() const {
+			return buf;
+		}
+		const char* data() const {
+			return buf;
+		}
+		char* data() {
+			return buf;
+		}
+		char operator[](size_t i) const {
+			return buf[i];
+		}
+		char& operator[](size_t i) {
+			return buf[i];
+		}
+		const char* begin() const {
+			return buf;
+		}
+		const char* end() const {
+			return buf + len;
+		}
+		std::string_view view() const {
+			return std::string_view(buf, len);
+		}
+		operator std::string_view() const {
+			return view();
+		}
+
+		void clear() {
+			len = 0;
+			buf[0] = 0;
+		}
+		bool push_back(char c) {
+			if (len == N)
+				return false;
+			buf[len++] = c;
+			buf[len] = 0;
+			return true;
+		}
+		bool append(const char* p, size_t n) {
+			if (n > N - len)
+				return false;
+			memcpy(buf + len, p, n);
+			len += n;
+			buf[len] = 0;
+			return true;
+		}
+		bool assign(std::string_view sv) {
+			clear();
+			return append(sv.data(), sv.size());
+		}
+
+		friend bool operator==(const fixed_string& a, const fixed_string& b) {
+			return a.view() == b.view();
+		}
+		friend bool operator!=(const fixed_string& a, const fixed_string& b) {
+			return a.view() != b.view();
+		}
+		friend bool operator<(const fixed_string& a, const fixed_string& b) {
+			return a.view() < b.view();
+		}
+	};
+
+	// vector of up to N elements, elements are only constructed when added
+	template<class T, size_t N>
+	class fixed_vector {
+		alignas(T) unsigned char storage[N * sizeof(T)];
+		size_t count = 0;
+	public:
+		using value_type = T;
+
+		fixed_vector() = default;
+		fixed_vector(const fixed_vector& o) {
+			for (auto& e : o)
+				emplace_back(e);
+		}
+		fixed_vector(fixed_vector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+			for (auto& e : o)
+				emplace_back(std::move(e));
+		}
+		fixed_vector& operator=(const fixed_vector& o) {
+			if (this != &o) {
+				clear();
+				for (auto& e : o)
+					emplace_back(e);
+			}
+			return *this;
+		}
+		fixed_vector& operator=(fixed_vector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+			if (this != &o) {
+				clear();
+				for (auto& e : o)
+					emplace_back(std::move(e));
+			}
+			return *this;
+		}
+		~fixed_vector() {
+			clear();
+		}
+
+		static constexpr size_t capacity() {
+			return N;
+		}
+		size_t size() const {
+			return count;
+		}
+		bool empty() const {
+			return count == 0;
+		}
+		bool full() const {
+			return count == N;
+		}
+		T* data() {
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+		const T* data() const {
+			return std::launder(reinterpret_cast<const T*>(storage));
+		}
+		T& operator[](size_t i) {
+			return data()[i];
+		}
+		const T& operator[](size_t i) const {
+			return data()[i];
+		}
+		T& back() {
+			return data()[count - 1];
+		}
+		const T& back() const {
+			return data()[count - 1];
+		}
+		T* begin() {
+			return data();
+		}
+		T* end() {
+			return data() + count;
+		}
+		const T* begin() const {
+			return data();
+		}
+		const T* end() const {
+			return data() + count;
+		}
+
+		// returns the new element or null if the vector is full
+		template<class ... ARGS>
+		T* emplace_back(ARGS&& ... args) {
+			if (count == N)
+				return nullptr;
+			T* rv = ::new ((void*)(storage + count * sizeof(T))) T(std::forward<ARGS>(args)...);
+			count++;
+			return rv;
+		}
+		bool push_back(const T& v) {
+			return emplace_back(v) != nullptr;
+		}
+		bool push_back(T&& v) {
+			return emplace_back(std::move(v)) != nullptr;
+		}
+		void pop_back() {
+			data()[--count].~T();
+		}
+		void clear() {
+			while (count)
+				pop_back();
+		}
+
+		friend bool operator==(const fixed_vector& a, const fixed_vector& b) {
+			if (a.count != b.count)
+				return false;
+			for (size_t i = 0; i < a.count; i++) {
+				if (!(a[i] == b[i]))
+					return false;
+			}
+			return true;
+		}
+		friend bool operator!=(const fixed_vector& a, const fixed_vector& b) {
+			return !(a == b);
+		}
+	};
+}
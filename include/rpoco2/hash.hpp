@@ -0,0 +1,417 @@
+#pragma once
+
+#include <string.h>
+
+#include "rpoco.hpp"
+#include "fixed.hpp"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rpoco2 {
+
+	// member option flag, excludes a member from the generated hashing, equality and ordering
+	// ie: RPOCO2(&T::key, opt{&T::cache, rpoco2::nohash})
+	static constexpr struct nohash_t {
+		constexpr nohash_t() {}
+	} nohash{};
+
+	namespace impl2 {
+
+		// 64bit multiply/xorshift mixing, one multiply per word
+		struct hash_state {
+			uint64_t h = 0x243F6A8885A308D3ull;
+
+			inline void add(uint64_t v) {
+				h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+				h ^= h >> 29;
+			}
+			inline void add_bytes(const void* p, size_t len) {
+				auto bp = static_cast<const unsigned char*>(p);
+				add(len);
+				while (len >= 8) {
+					uint64_t v;
+					memcpy(&v, bp, 8);
+					add(v);
+					bp += 8;
+					len -= 8;
+				}
+				if (len) {
+					uint64_t v = 0;
+					memcpy(&v, bp, len);
+					add(v);
+				}
+			}
+			// final avalanche (murmur3 fmix64)
+			inline uint64_t finish() const {
+				uint64_t v = h;
+				v ^= v >> 33;
+				v *= 0xFF51AFD7ED558CCDull;
+				v ^= v >> 33;
+				v *= 0xC4CEB9FE1A85EC53ull;
+				v ^= v >> 33;
+				return v;
+			}
+		};
+
+		// types whose object representation can be hashed and compared as one contiguous run,
+		// char arrays are strings and are excluded since bytes after the terminator are undefined
+		template<class T>
+		constexpr bool bulk();
+
+		template<class T, std::size_t ... I>
+		constexpr bool rpoco_bulk(std::index_sequence<I...>) {
+			using TI = std::remove_const_t<decltype(tinfo<T>)>;
+			// the declared members must cover the whole object, members left out of the list don't take part
+			return (std::size_t(0) + ... + sizeof(typename TI::template member_type<I>)) == sizeof(T)
+				&& ((!has_opt_v<nohash_t, typename TI::template member_options<I>> && bulk<typename TI::template member_type<I>>()) && ...);
+		}
+
+		template<class T>
+		constexpr bool bulk() {
+			if constexpr (!std::has_unique_object_representations_v<T>) {
+				return false;
+			} else if constexpr (std::is_array_v<T>) {
+				return !std::is_same_v<std::remove_extent_t<T>, char> && bulk<std::remove_extent_t<T>>();
+			} else if constexpr (is_rpoco_v<T>) {
+				return rpoco_bulk<T>(std::make_index_sequence<std::remove_const_t<decltype(tinfo<T>)>::count>());
+			} else {
+				return std::is_scalar_v<T>;
+			}
+		}
+
+		// hash/equality/ordering of a single value, specialized per type like the json parser
+		template<class T, class = void>
+		struct value_ops {
+			static void hash(hash_state& hs, const T& v) {
+				if constexpr (std::is_floating_point_v<T>) {
+					// -0.0 and 0.0 compare equal and so do all NaNs, so they must hash equal
+					T nv = v == 0 ? T(0) : v != v ? std::numeric_limits<T>::quiet_NaN() : v;
+					if constexpr (std::is_same_v<T, long double>) {
+						// long double may carry padding (x87 keeps 80 value bits in 16 bytes), hash the value by its parts
+						if (!std::isfinite(nv)) {
+							double d = (double)nv;
+							hs.add_bytes(&d, sizeof(d));
+							return;
+						}
+						int e = 0;
+						T f = std::fabs(std::frexp(nv, &e));
+						for (int bits = 0; bits < std::numeric_limits<T>::digits; bits += 32) {
+							f = std::ldexp(f, 32);
+							T w = std::floor(f);
+							hs.add((uint64_t)w);
+							f -= w;
+						}
+						hs.add((uint64_t)(int64_t)e);
+						hs.add(std::signbit(nv) ? 1 : 0);
+					} else {
+						hs.add_bytes(&nv, sizeof(T));
+					}
+				} else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+					hs.add((uint64_t)v);
+				} else {
+					hs.add(std::hash<T>{}(v));
+				}
+			}
+			// NaN equals NaN and orders after all other values so records holding one still equal themselves
+			static bool equal(const T& a, const T& b) {
+				if constexpr (std::is_floating_point_v<T>)
+					return a == b || (a != a && b != b);
+				else
+					return a == b;
+			}
+			static int compare(const T& a, const T& b) {
+				if constexpr (std::is_floating_point_v<T>) {
+					if (a != a || b != b)
+						return (a != a) - (b != b);
+				}
+				return a < b ? -1 : b < a ? 1 : 0;
+			}
+		};
+
+		template<class T>
+		struct value_ops<T, std::enable_if_t<is_rpoco_v<T>>> {
+			using TI = std::remove_const_t<decltype(tinfo<T>)>;
+
+			template<std::size_t I>
+			static constexpr bool skip() {
+				return has_opt_v<nohash_t, typename TI::template member_options<I>>;
+			}
+
+			template<std::size_t ... I>
+			static void hash_impl(hash_state& hs, const T& v, std::index_sequence<I...>) {
+				((skip<I>() ? void() : value_ops<typename TI::template member_type<I>>::hash(hs, v.*(tinfo<T>.template member_ptr<I>()))), ...);
+			}
+			template<std::size_t ... I>
+			static bool equal_impl(const T& a, const T& b, std::index_sequence<I...>) {
+				return ((skip<I>() || value_ops<typename TI::template member_type<I>>::equal(a.*(tinfo<T>.template member_ptr<I>()), b.*(tinfo<T>.template member_ptr<I>()))) && ...);
+			}
+			template<std::size_t ... I>
+			static int compare_impl(const T& a, const T& b, std::index_sequence<I...>) {
+				int rv = 0;
+				// stops at the first member that differs
+				((skip<I>() || 0 == (rv = value_ops<typename TI::template member_type<I>>::compare(a.*(tinfo<T>.template member_ptr<I>()), b.*(tinfo<T>.template member_ptr<I>())))) && ...);
+				return rv;
+			}
+
+			static void hash(hash_state& hs, const T& v) {
+				if constexpr (bulk<T>())
+					hs.add_bytes(&v, sizeof(T));
+				else
+					hash_impl(hs, v, std::make_index_sequence<TI::count>());
+			}
+			static bool equal(const T& a, const T& b) {
+				if constexpr (bulk<T>())
+					return 0 == memcmp(&a, &b, sizeof(T));
+				else
+					return equal_impl(a, b, std::make_index_sequence<TI::count>());
+			}
+			static int compare(const T& a, const T& b) {
+				return compare_impl(a, b, std::make_index_sequence<TI::count>());
+			}
+		};
+
+		// shared code for sequences, runs of trivial elements are hashed in bulk
+		template<class T>
+		struct seq_ops {
+			static void hash(hash_state& hs, const T* p, size_t count) {
+				if constexpr (bulk<T>()) {
+					hs.add_bytes(p, count * sizeof(T));
+				} else {
+					hs.add(count);
+					for (size_t i = 0; i < count; i++)
+						value_ops<T>::hash(hs, p[i]);
+				}
+			}
+			static bool equal(const T* a, size_t acount, const T* b, size_t bcount) {
+				if (acount != bcount)
+					return false;
+				if constexpr (bulk<T>()) {
+					return acount == 0 || 0 == memcmp(a, b, acount * sizeof(T));
+				} else {
+					for (size_t i = 0; i < acount; i++)
+						if (!value_ops<T>::equal(a[i], b[i]))
+							return false;
+					return true;
+				}
+			}
+			static int compare(const T* a, size_t acount, const T* b, size_t bcount) {
+				size_t count = acount < bcount ? acount : bcount;
+				for (size_t i = 0; i < count; i++) {
+					int rv = value_ops<T>::compare(a[i], b[i]);
+					if (rv)
+						return rv;
+				}
+				return acount < bcount ? -1 : bcount < acount ? 1 : 0;
+			}
+		};
+
+		template<class T, size_t L>
+		struct value_ops<T[L]> {
+			static void hash(hash_state& hs, const T(&v)[L]) {
+				seq_ops<T>::hash(hs, v, L);
+			}
+			static bool equal(const T(&a)[L], const T(&b)[L]) {
+				return seq_ops<T>::equal(a, L, b, L);
+			}
+			static int compare(const T(&a)[L], const T(&b)[L]) {
+				return seq_ops<T>::compare(a, L, b, L);
+			}
+		};
+
+		// char arrays are zero terminated strings, bytes after the terminator are ignored
+		template<size_t L>
+		struct value_ops<char[L]> {
+			static size_t len(const char(&v)[L]) {
+				auto e = static_cast<const char*>(memchr(v, 0, L));
+				return e ? e - v : L;
+			}
+			static void hash(hash_state& hs, const char(&v)[L]) {
+				hs.add_bytes(v, len(v));
+			}
+			static bool equal(const char(&a)[L], const char(&b)[L]) {
+				return std::string_view(a, len(a)) == std::string_view(b, len(b));
+			}
+			static int compare(const char(&a)[L], const char(&b)[L]) {
+				return std::string_view(a, len(a)).compare(std::string_view(b, len(b)));
+			}
+		};
+
+		template<class T, size_t L>
+		struct value_ops<std::array<T, L>> {
+			static void hash(hash_state& hs, const std::array<T, L>& v) {
+				seq_ops<T>::hash(hs, v.data(), L);
+			}
+			static bool equal(const std::array<T, L>& a, const std::array<T, L>& b) {
+				return seq_ops<T>::equal(a.data(), L, b.data(), L);
+			}
+			static int compare(const std::array<T, L>& a, const std::array<T, L>& b) {
+				return seq_ops<T>::compare(a.data(), L, b.data(), L);
+			}
+		};
+
+		template<class CT, class TR, class A>
+		struct value_ops<std::basic_string<CT, TR, A>> {
+			using S = std::basic_string<CT, TR, A>;
+			static void hash(hash_state& hs, const S& v) {
+				hs.add_bytes(v.data(), v.size() * sizeof(CT));
+			}
+			static bool equal(const S& a, const S& b) {
+				return a == b;
+			}
+			static int compare(const S& a, const S& b) {
+				return a.compare(b);
+			}
+		};
+
+		template<class T, class A>
+		struct value_ops<std::vector<T, A>> {
+			using V = std::vector<T, A>;
+			static void hash(hash_state& hs, const V& v) {
+				seq_ops<T>::hash(hs, v.data(), v.size());
+			}
+			static bool equal(const V& a, const V& b) {
+				return seq_ops<T>::equal(a.data(), a.size(), b.data(), b.size());
+			}
+			static int compare(const V& a, const V& b) {
+				return seq_ops<T>::compare(a.data(), a.size(), b.data(), b.size());
+			}
+		};
+
+		template<class K, class V, class C, class A>
+		struct value_ops<std::map<K, V, C, A>> {
+			using M = std::map<K, V, C, A>;
+			static void hash(hash_state& hs, const M& v) {
+				hs.add(v.size());
+				for (auto& kv : v) {
+					value_ops<K>::hash(hs, kv.first);
+					value_ops<V>::hash(hs, kv.second);
+				}
+			}
+			static bool equal(const M& a, const M& b) {
+				if (a.size() != b.size())
+					return false;
+				for (auto ai = a.begin(), bi = b.begin(); ai != a.end(); ++ai, ++bi) {
+					if (!value_ops<K>::equal(ai->first, bi->first) || !value_ops<V>::equal(ai->second, bi->second))
+						return false;
+				}
+				return true;
+			}
+			static int compare(const M& a, const M& b) {
+				auto ai = a.begin(), bi = b.begin();
+				for (; ai != a.end() && bi != b.end(); ++ai, ++bi) {
+					int rv = value_ops<K>::compare(ai->first, bi->first);
+					if (!rv)
+						rv = value_ops<V>::compare(ai->second, bi->second);
+					if (rv)
+						return rv;
+				}
+				return ai != a.end() ? 1 : bi != b.end() ? -1 : 0;
+			}
+		};
+
+		// pointers and optionals are compared by content, null sorts first
+		template<class P, class T>
+		struct nullable_ops {
+			static void hash(hash_state& hs, const P& v) {
+				hs.add(v ? 1 : 0);
+				if (v)
+					value_ops<T>::hash(hs, *v);
+			}
+			static bool equal(const P& a, const P& b) {
+				if (!a || !b)
+					return !a == !b;
+				return value_ops<T>::equal(*a, *b);
+			}
+			static int compare(const P& a, const P& b) {
+				if (!a || !b)
+					return (a ? 1 : 0) - (b ? 1 : 0);
+				return value_ops<T>::compare(*a, *b);
+			}
+		};
+
+		template<class T>
+		struct value_ops<std::shared_ptr<T>> : nullable_ops<std::shared_ptr<T>, T> {};
+		template<class T, class D>
+		struct value_ops<std::unique_ptr<T, D>> : nullable_ops<std::unique_ptr<T, D>, T> {};
+		template<class T>
+		struct value_ops<std::optional<T>> : nullable_ops<std::optional<T>, T> {};
+
+		template<size_t N>
+		struct value_ops<fixed_string<N>> {
+			using S = fixed_string<N>;
+			static void hash(hash_state& hs, const S& v) {
+				hs.add_bytes(v.data(), v.size());
+			}
+			static bool equal(const S& a, const S& b) {
+				return a.view() == b.view();
+			}
+			static int compare(const S& a, const S& b) {
+				return a.view().compare(b.view());
+			}
+		};
+
+		template<class T, size_t N>
+		struct value_ops<fixed_vector<T, N>> {
+			using V = fixed_vector<T, N>;
+			static void hash(hash_state& hs, const V& v) {
+				seq_ops<T>::hash(hs, v.data(), v.size());
+			}
+			static bool equal(const V& a, const V& b) {
+				return seq_ops<T>::equal(a.data(), a.size(), b.data(), b.size());
+			}
+			static int compare(const V& a, const V& b) {
+				return seq_ops<T>::compare(a.data(), a.size(), b.data(), b.size());
+			}
+		};
+	}
+
+	// member-wise hash of an RPOCO2 type (or any type supported by the member hashing)
+	template<class T>
+	uint64_t hash_value(const T& v) {
+		impl2::hash_state hs;
+		impl2::value_ops<T>::hash(hs, v);
+		return hs.finish();
+	}
+
+	// member-wise equality
+	template<class T>
+	bool equal(const T& a, const T& b) {
+		return impl2::value_ops<T>::equal(a, b);
+	}
+
+	// member-wise lexicographic ordering in declaration order, returns <0, 0 or >0
+	template<class T>
+	int compare(const T& a, const T& b) {
+		return impl2::value_ops<T>::compare(a, b);
+	}
+
+	// functors for use with the standard containers,
+	// ie: std::unordered_map<K, V, rpoco2::hash<K>, rpoco2::equal_to<K>>
+	template<class T>
+	struct hash {
+		size_t operator()(const T& v) const {
+			return (size_t)hash_value(v);
+		}
+	};
+
+	template<class T>
+	struct equal_to {
+		bool operator()(const T& a, const T& b) const {
+			return equal(a, b);
+		}
+	};
+
+	template<class T>
+	struct less {
+		bool operator()(const T& a, const T& b) const {
+			return compare(a, b) < 0;
+		}
+	};
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rpoco2 {
+
+	struct intern_stats {
+		size_t lookups;   // total intern calls
+		size_t hits;      // calls that found an existing string
+		size_t unique;    // distinct strings in the pool
+		size_t bytes;     // characters stored
+	};
+
+	// a pooled string, the hash is computed once when the string enters the pool
+	struct intern_entry {
+		std::string str;
+		size_t hash;
+	};
+
+	// concurrent string pool, sharded by hash with a reader/writer lock per shard.
+	// Entries live as long as the pool, the global pool lives for the whole process.
+	class intern_pool {
+		struct key {
+			std::string_view sv;
+			size_t hash;
+		};
+		struct key_hash {
+			size_t operator()(const key& k) const {
+				return k.hash;
+			}
+		};
+		struct key_equal {
+			bool operator()(const key& a, const key& b) const {
+				return a.sv == b.sv;
+			}
+		};
+		struct shard {
+			std::shared_mutex lock;
+			std::unordered_map<key, std::unique_ptr<intern_entry>, key_hash, key_equal> set;
+			size_t bytes = 0;
+		};
+		static constexpr size_t shard_count = 16;
+
+		shard shards[shard_count];
+		std::atomic<size_t> lookups{ 0 };
+		std::atomic<size_t> hits{ 0 };
+	public:
+		const intern_entry* intern(std::string_view sv) {
+			lookups.fetch_add(1, std::memory_order_relaxed);
+			key k{ sv, std::hash<std::string_view>{}(sv) };
+			shard& sh = shards[(k.hash >> 7) % shard_count];
+			{
+				// most lookups are hits and only need the shared lock
+				std::shared_lock<std::shared_mutex> rl(sh.lock);
+				auto it = sh.set.find(k);
+				if (it != sh.set.end()) {
+					hits.fetch_add(1, std::memory_order_relaxed);
+					return it->second.get();
+				}
+			}
+			std::unique_lock<std::shared_mutex> wl(sh.lock);
+			auto it = sh.set.find(k);
+			if (it != sh.set.end()) {
+				hits.fetch_add(1, std::memory_order_relaxed);
+				return it->second.get();
+			}
+			auto entry = std::make_unique<intern_entry>(intern_entry{ std::string(sv), k.hash });
+			const intern_entry* rv = entry.get();
+			// the key views the pooled copy, not the caller's bytes
+			sh.set.emplace(key{ rv->str, k.hash }, std::move(entry));
+			sh.bytes += sv.size();
+			return rv;
+		}
+
+		intern_stats stats() {
+			intern_stats rv{ lookups.load(std::memory_order_relaxed), hits.load(std::memory_order_relaxed), 0, 0 };
+			for (auto& sh : shards) {
+				std::shared_lock<std::shared_mutex> rl(sh.lock);
+				rv.unique += sh.set.size();
+				rv.bytes += sh.bytes;
+			}
+			return rv;
+		}
+
+		static intern_pool& global() {
+			static intern_pool pool;
+			return pool;
+		}
+	};
+
+	// handle to an interned string, copies share the pooled string
+	class interned {
+		const intern_entry* entry = nullptr;
+	public:
+		interned() = default;
+		explicit interned(std::string_view sv, intern_pool& pool = intern_pool::global()) : entry(sv.empty() ? nullptr : pool.intern(sv)) {}
+
+		std::string_view view() const {
+			return entry ? std::string_view(entry->str) : std::string_view();
+		}
+		const char* c_str() const {
+			return entry ? entry->str.c_str() : "";
+		}
+		bool empty() const {
+			return !entry;
+		}
+		size_t hash() const {
+			return entry ? entry->hash : std::hash<std::string_view>{}(std::string_view());
+		}
+		operator std::string_view() const {
+			return view();
+		}
+
+		// strings from the same pool compare by pointer, the content check covers handles from different pools
+		friend bool operator==(const interned& a, const interned& b) {
+			return a.entry == b.entry || (a.hash() == b.hash() && a.view() == b.view());
+		}
+		friend bool operator!=(const interned& a, const interned& b) {
+			return !(a == b);
+		}
+		friend bool operator<(const interned& a, const interned& b) {
+			return a.entry != b.entry && a.view() < b.view();
+		}
+	};
+}
+
+namespace std {
+	template<>
+	struct hash<rpoco2::interned> {
+		size_t operator()(const rpoco2::interned& v) const {
+			return v.hash();
+		}
+	};
+}
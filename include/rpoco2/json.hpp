@@ -6,28 +6,263 @@
 
 #include "rpoco.hpp"
 
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RPOCO2_SSE2 1
+#include <emmintrin.h>
+#else
+#define RPOCO2_SSE2 0
+#endif
+
+// SSSE3 adds byte shuffles, used as 16 entry lookup tables by the utf-8 validation
+#if RPOCO2_SSE2 && (defined(__SSSE3__) || defined(__AVX__))
+#define RPOCO2_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define RPOCO2_SSSE3 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace rpoco2 {
 	namespace json {
 
+		// how strings with invalid utf-8 (or unpaired \u surrogates) are treated
+		enum class utf8_mode {
+			reject=0,   // fail the parse
+			replace,    // substitute U+FFFD
+			pass        // no validation, bytes are copied as is (for trusted input)
+		};
+
+		struct parse_options {
+			utf8_mode utf8 = utf8_mode::reject;
+			std::pmr::memory_resource* resource = nullptr;   // if set, containers created while parsing allocate from it
+			bool pmr_dom = false;                            // std::any builds its dom from std::pmr containers on resource
+		};
 
 		namespace impl {
 			template<typename CTX>
-			bool parse_ignore(CTX& ctx); // parse_ignore ignores everything but is a good template for parsing anything
+			constexpr bool parse_ignore(CTX& ctx); // parse_ignore ignores everything but is a good template for parsing anything
 
+			// contexts over contiguous memory expose cur()/end()/advance(n) so scanning can work on the raw bytes
+			template<class CTX, class = void>
+			struct has_span : std::false_type {};
+			template<class CTX>
+			struct has_span<CTX, std::void_t<decltype(std::declval<CTX&>().cur()), decltype(std::declval<CTX&>().advance(1))>> : std::true_type {};
 
+			// contexts used in constant evaluation
+			template<class CTX, class = void>
+			struct is_constant_ctx : std::false_type {};
 			template<class CTX>
-			inline bool skip_space(CTX& ctx) {
-				while (!ctx.eof() && isspace(ctx.peek())) {
-					ctx.ignore();
+			struct is_constant_ctx<CTX, std::enable_if_t<CTX::constant>> : std::true_type {};
+
+			// contexts may carry parse_options as an options member
+			template<class CTX, class = void>
+			struct has_options : std::false_type {};
+			template<class CTX>
+			struct has_options<CTX, std::void_t<decltype(std::declval<CTX&>().options)>> : std::true_type {};
+
+			// string writers may bulk append
+			template<class DST, class = void>
+			struct has_append : std::false_type {};
+			template<class DST>
+			struct has_append<DST, std::void_t<decltype(std::declval<DST&>().append((const char*)nullptr, size_t(0)))>> : std::true_type {};
+
+			template<class CTX>
+			constexpr utf8_mode ctx_utf8(CTX& ctx) {
+				if constexpr (has_options<CTX>::value)
+					return ctx.options.utf8;
+				else
+					return utf8_mode::reject;
+			}
+
+			template<class CTX>
+			constexpr bool ctx_pmr_dom(CTX& ctx) {
+				if constexpr (has_options<CTX>::value)
+					return ctx.options.pmr_dom;
+				else
+					return false;
+			}
+
+			template<class CTX>
+			constexpr std::pmr::memory_resource* ctx_resource(CTX& ctx) {
+				if constexpr (has_options<CTX>::value)
+					return ctx.options.resource;
+				else
+					return nullptr;
+			}
+
+			// empty pmr containers still on the default resource (ie: members of a default constructed object)
+			// are moved onto the parse resource before they're filled, other containers are left as is
+			template<class C, class CTX>
+			void adopt_resource(C& c, CTX& ctx) {
+				if constexpr (std::is_same_v<typename C::allocator_type, std::pmr::polymorphic_allocator<typename C::value_type>>) {
+					std::pmr::memory_resource* res = ctx_resource(ctx);
+					if (res && res != std::pmr::get_default_resource() && c.empty() && c.get_allocator().resource() == std::pmr::get_default_resource()) {
+						// polymorphic allocators don't propagate on assignment so the container is rebuilt in place
+						c.~C();
+						::new ((void*)&c) C(typename C::allocator_type(res));
+					}
+				}
+			}
+
+			inline int ctz32(unsigned int v) {
+#ifdef _MSC_VER
+				unsigned long idx;
+				_BitScanForward(&idx, v);
+				return (int)idx;
+#else
+				return __builtin_ctz(v);
+#endif
+			}
+
+			inline int ctz64(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+				unsigned long idx;
+				_BitScanForward64(&idx, v);
+				return (int)idx;
+#elif defined(_MSC_VER)
+				return (uint32_t)v ? ctz32((uint32_t)v) : 32 + ctz32((uint32_t)(v >> 32));
+#else
+				return __builtin_ctzll(v);
+#endif
+			}
+
+			inline int clz64(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+				unsigned long idx;
+				_BitScanReverse64(&idx, v);
+				return 63 - (int)idx;
+#elif defined(_MSC_VER)
+				unsigned long idx;
+				if (v >> 32) {
+					_BitScanReverse(&idx, (uint32_t)(v >> 32));
+					return 31 - (int)idx;
+				}
+				_BitScanReverse(&idx, (uint32_t)v);
+				return 63 - (int)idx;
+#else
+				return __builtin_clzll(v);
+#endif
+			}
+
+			inline int popcount64(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+				return (int)__popcnt64(v);
+#elif defined(_MSC_VER)
+				return (int)(__popcnt((uint32_t)v) + __popcnt((uint32_t)(v >> 32)));
+#else
+				return __builtin_popcountll(v);
+#endif
+			}
+
+			// length of the run of string bytes that need no special handling (stops at quotes, backslashes and control characters)
+			inline size_t scan_string(const char* p, const char* e) {
+				const char* s = p;
+#if RPOCO2_SSE2
+				const __m128i quote = _mm_set1_epi8('\"');
+				const __m128i bslash = _mm_set1_epi8('\\');
+				const __m128i space = _mm_set1_epi8(0x20);
+				const __m128i neg = _mm_set1_epi8(-1);
+				while (e - p >= 16) {
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					// signed compare, bytes >= 0x80 are negative so mask them back out from the control test
+					__m128i ctl = _mm_and_si128(_mm_cmplt_epi8(v, space), _mm_cmpgt_epi8(v, neg));
+					__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)), ctl);
+					int mask = _mm_movemask_epi8(m);
+					if (mask)
+						return (p - s) + ctz32(mask);
+					p += 16;
+				}
+#endif
+				while (p < e) {
+					unsigned char c = *p;
+					if (c == '\"' || c == '\\' || c < 0x20)
+						break;
+					p++;
+				}
+				return p - s;
+			}
+
+
+			// json whitespace
+			constexpr bool is_space(char c) {
+				return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+			}
+
+			// length of the run of whitespace starting at p
+			inline size_t scan_space(const char* p, const char* e) {
+				const char* s = p;
+				// most runs are a single space or none at all
+				if (p < e && !is_space(*p))
+					return 0;
+#if RPOCO2_SSE2
+				const __m128i sp = _mm_set1_epi8(' ');
+				const __m128i nl = _mm_set1_epi8('\n');
+				const __m128i cr = _mm_set1_epi8('\r');
+				const __m128i tab = _mm_set1_epi8('\t');
+				while (e - p >= 16) {
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, nl)), _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, tab)));
+					int mask = _mm_movemask_epi8(m) ^ 0xFFFF;
+					if (mask)
+						return (p - s) + ctz32(mask);
+					p += 16;
+				}
+#endif
+				while (p < e && is_space(*p))
+					p++;
+				return p - s;
+			}
+
+			template<class CTX>
+			constexpr bool skip_space(CTX& ctx) {
+				if constexpr (has_span<CTX>::value) {
+					ctx.advance(scan_space(ctx.cur(), ctx.end()));
+				} else {
+					while (!ctx.eof() && is_space(ctx.peek())) {
+						ctx.ignore();
+					}
 				}
 				return !ctx.eof();
 			}
 
+			// m*10^e, steps through exact powers of ten so large exponents neither overflow on the way nor pick up
+			// rounding errors. The steps go up to 10^26 where long double has a 64 bit significand (x87) which
+			// rounds every power of ten to the nearest double, otherwise they stop at 10^22 (exact in double).
+			// Used both at runtime and in constant evaluation so the two always agree.
+			constexpr long double scale10(long double m, int e) {
+				constexpr long double exact[] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+					1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L };
+				constexpr unsigned int step = std::numeric_limits<long double>::digits >= 64 ? 26 : 22;
+				unsigned int n = e < 0 ? 0u - (unsigned int)e : (unsigned int)e;
+				for (; n > step; n -= step)
+					m = e < 0 ? m / exact[step] : m * exact[step];
+				return e < 0 ? m / exact[n] : m * exact[n];
+			}
+
+			// appends a digit to a floating point significand, digits past what 64 bits hold only move the exponent
+			constexpr void push_digit(std::uint64_t& m, int& e, int d, bool frac) {
+				if (m < 1844674407370955161u) {
+					m = m * 10 + d;
+					if (frac)
+						e--;
+				} else if (!frac) {
+					e++;
+				}
+			}
+
 			template<class DST, class CTX>
-			inline bool parse_number(DST& dst, CTX& ctx) {
+			constexpr bool parse_number(DST& dst, CTX& ctx) {
 				if (!skip_space(ctx))
 					return false;
-				DST mul;
+				DST mul = 1;
 				bool neg = ctx.peek() == '-';
 				if (neg) {
 					mul = -1;
@@ -36,12 +271,17 @@ namespace rpoco2 {
 					mul = 1;
 				}
 				DST ov = 0;
+				std::uint64_t m = 0; // floating point significand and its power of ten
+				int me = 0;
 				auto c = ctx.get();
 				if (c == '0') {
 					c = ctx.peek();
-				} else if ('1' <= c || c <= '9') {
+				} else if ('1' <= c && c <= '9') {
 					while (true) {
-						ov = ov * 10 + (c - '0');
+						if constexpr (std::is_integral_v<DST>)
+							ov = ov * 10 + (c - '0');
+						else
+							push_digit(m, me, c - '0', false);
 						c = ctx.peek();
 						if (c < '0' || '9' < c)
 							break;
@@ -53,17 +293,14 @@ namespace rpoco2 {
 					dst = ov * mul;
 					return true;
 				} else {
-					DST tm = 1;
 					if (c == '.') {
 						ctx.get(); // clear off dot
 						c = ctx.peek();
 						if (c < '0' || '9' < c)
 							return false;
 						while ('0' <= c && c <= '9') {
-							//printf("Parsing FLT:'%c'\n", c);
 							ctx.ignore(); // ok num, use it
-							tm *= (DST)0.1;
-							ov = ov + tm * (DST)(c - '0');
+							push_digit(m, me, c - '0', true);
 							c = ctx.peek();
 						}
 					}
@@ -91,72 +328,391 @@ namespace rpoco2 {
 						if (!isValid && (c < '0' || '9' < c))
 							return false;
 						while('0'<=c && c<='9') {
-							exp = exp*10 + (c-'0');
+							if (exp < 100000)
+								exp = exp*10 + (c-'0');
 							ctx.ignore();
 							c = ctx.peek();
 						}
-						dst = ov * mul * (DST)pow(10,eSgn*exp);
-					} else {
-						dst = ov * mul;
+						me += eSgn * exp;
 					}
+					dst = mul * (DST)scale10((long double)m, me);
 					return true;
 				}
 				//std::is_integral<DST>
 			}
 
+			// length of a utf-8 sequence from its lead byte, 0 for bytes that can't start a sequence
+			constexpr int utf8_len(unsigned char c) {
+				return c < 0x80 ? 1 : c < 0xC2 ? 0 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : c < 0xF5 ? 4 : 0;
+			}
+
+			// is c a valid byte at position idx (1..3) of a sequence started by lead (excludes overlongs and surrogates)
+			constexpr bool utf8_cont(unsigned char lead, unsigned char c, int idx) {
+				if (idx == 1) {
+					switch (lead) {
+					case 0xE0: return 0xA0 <= c && c <= 0xBF;
+					case 0xED: return 0x80 <= c && c <= 0x9F;
+					case 0xF0: return 0x90 <= c && c <= 0xBF;
+					case 0xF4: return 0x80 <= c && c <= 0x8F;
+					}
+				}
+				return (c & 0xC0) == 0x80;
+			}
+
+			// returns the length of the valid utf-8 prefix of s, bad is set to the length of the
+			// invalid sequence found at that point (the maximal subpart that replacement consumes)
+			inline size_t utf8_validate(const char* s, size_t n, size_t& bad) {
+				auto p = reinterpret_cast<const unsigned char*>(s);
+				size_t i = 0;
+				while (i < n) {
+#if RPOCO2_SSE2
+					// skip ascii 16 bytes at a time
+					while (n - i >= 16) {
+						int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+						if (mask) {
+							i += ctz32(mask);
+							break;
+						}
+						i += 16;
+					}
+					if (i >= n)
+						break;
+#endif
+					unsigned char c = p[i];
+					int len = utf8_len(c);
+					if (len == 1) {
+						i++;
+						continue;
+					}
+					int k = 1;
+					while (k < len && i + k < n && utf8_cont(c, p[i + k], k))
+						k++;
+					if (len == 0 || k < len) {
+						bad = len == 0 ? 1 : k;
+						return i;
+					}
+					i += len;
+				}
+				bad = 0;
+				return n;
+			}
+
+#if RPOCO2_SSSE3
+			// block-wise utf-8 validation with lookup tables on the high and low nibbles of each byte pair
+			// (the classification of Keiser and Lemire), errors from all blocks accumulate in error
+			struct utf8_checker {
+				__m128i prev = _mm_setzero_si128();
+				__m128i prev_incomplete = _mm_setzero_si128();
+				__m128i error = _mm_setzero_si128();
+
+				static __m128i high_nibbles(__m128i v) {
+					return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+				}
+
+				inline void block(__m128i input) {
+					if (!_mm_movemask_epi8(input)) {
+						// ascii, only a sequence left open by the previous block can be wrong
+						error = _mm_or_si128(error, prev_incomplete);
+						prev_incomplete = _mm_setzero_si128();
+						prev = input;
+						return;
+					}
+					const char TOO_SHORT = 1 << 0, TOO_LONG = 1 << 1, OVERLONG_3 = 1 << 2, TOO_LARGE = 1 << 3, SURROGATE = 1 << 4,
+						OVERLONG_2 = 1 << 5, TOO_LARGE_1000 = 1 << 6, OVERLONG_4 = 1 << 6, TWO_CONTS = (char)(1 << 7);
+					const char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+					const __m128i byte_1_high_tbl = _mm_setr_epi8(
+						TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+						TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+						TOO_SHORT | OVERLONG_2,
+						TOO_SHORT,
+						TOO_SHORT | OVERLONG_3 | SURROGATE,
+						TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+					const __m128i byte_1_low_tbl = _mm_setr_epi8(
+						CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+						CARRY | OVERLONG_2,
+						CARRY,
+						CARRY,
+						CARRY | TOO_LARGE,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+						CARRY | TOO_LARGE | TOO_LARGE_1000,
+						CARRY | TOO_LARGE | TOO_LARGE_1000);
+					const __m128i byte_2_high_tbl = _mm_setr_epi8(
+						TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+						TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+						TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+						TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+						TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+						TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+					__m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+					__m128i special = _mm_and_si128(_mm_and_si128(
+						_mm_shuffle_epi8(byte_1_high_tbl, high_nibbles(prev1)),
+						_mm_shuffle_epi8(byte_1_low_tbl, _mm_and_si128(prev1, _mm_set1_epi8(0x0F)))),
+						_mm_shuffle_epi8(byte_2_high_tbl, high_nibbles(input)));
+					// the 3rd and 4th bytes of 3 and 4 byte sequences must be continuations
+					__m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8((char)(0xE0 - 0x80)));
+					__m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8((char)(0xF0 - 0x80)));
+					__m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+					error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+
+					// sequences that continue into the next block
+					const __m128i max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xEF, (char)0xDF, (char)0xBF);
+					prev_incomplete = _mm_subs_epu8(input, max_value);
+					prev = input;
+				}
+
+				inline bool has_error() const {
+					return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF;
+				}
+			};
+
+			// start of the sequence containing the first byte of the block at p, everything before it is valid
+			inline const char* utf8_block_boundary(const char* s, const char* p) {
+				for (int k = 1; k <= 3 && p - k >= s; k++) {
+					unsigned char c = p[-k];
+					if (c < 0x80)
+						break;
+					if (c >= 0xC0) {
+						// an invalid lead is an error of its own
+						int len = utf8_len(c);
+						return len == 0 || len > k ? p - k : p;
+					}
+				}
+				return p;
+			}
+#endif
+
+			// scan_string with the utf-8 validation folded into the same pass over the bytes,
+			// valid receives the length of the run prefix known to be valid utf-8 (ending on a sequence boundary),
+			// the remainder of the run must be checked with utf8_validate
+			inline size_t scan_string_utf8(const char* p, const char* e, size_t& valid) {
+#if RPOCO2_SSSE3
+				const char* s = p;
+				const __m128i quote = _mm_set1_epi8('\"');
+				const __m128i bslash = _mm_set1_epi8('\\');
+				const __m128i space = _mm_set1_epi8(0x20);
+				const __m128i neg = _mm_set1_epi8(-1);
+				const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+				utf8_checker chk;
+				// errors are collected every 4 blocks, everything before the last clean check is valid
+				const char* clean = p;
+				int blocks = 0;
+				while (true) {
+					__m128i v;
+					if (e - p >= 16) {
+						v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					} else {
+						// zero padding stops the run like any control character
+						alignas(16) char buf[16] = {};
+						memcpy(buf, p, e - p);
+						v = _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+					}
+					__m128i ctl = _mm_and_si128(_mm_cmplt_epi8(v, space), _mm_cmpgt_epi8(v, neg));
+					int stop = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)), ctl));
+					if (stop) {
+						int at = ctz32(stop);
+						// bytes from the stop on are zeroed so a sequence cut short by it is an error
+						chk.block(_mm_and_si128(v, _mm_cmpgt_epi8(_mm_set1_epi8((char)at), lanes)));
+						size_t n = (p - s) + at;
+						valid = chk.has_error() ? utf8_block_boundary(s, clean) - s : n;
+						return n;
+					}
+					chk.block(v);
+					p += 16;
+					if (++blocks == 4) {
+						if (chk.has_error()) {
+							valid = utf8_block_boundary(s, clean) - s;
+							return (clean - s) + scan_string(clean, e);
+						}
+						clean = p;
+						blocks = 0;
+					}
+				}
+#else
+				valid = 0;
+				return scan_string(p, e);
+#endif
+			}
+
+			// append a codepoint as utf-8
+			template<class DST>
+			constexpr bool put_utf8(DST& dst, uint32_t cp) {
+				if (cp < 0x80)
+					return dst.put((char)cp);
+				if (cp < 0x800)
+					return dst.put((char)(0xC0 | (cp >> 6))) && dst.put((char)(0x80 | (cp & 0x3F)));
+				if (cp < 0x10000)
+					return dst.put((char)(0xE0 | (cp >> 12))) && dst.put((char)(0x80 | ((cp >> 6) & 0x3F))) && dst.put((char)(0x80 | (cp & 0x3F)));
+				return dst.put((char)(0xF0 | (cp >> 18))) && dst.put((char)(0x80 | ((cp >> 12) & 0x3F)))
+					&& dst.put((char)(0x80 | ((cp >> 6) & 0x3F))) && dst.put((char)(0x80 | (cp & 0x3F)));
+			}
+
+			// writers may provide an append(ptr,len) for bulk copies, otherwise we put char by char
+			template<class DST>
+			constexpr bool put_run(DST& dst, const char* p, size_t n) {
+				if constexpr (has_append<DST>::value) {
+					return dst.append(p, n);
+				} else {
+					for (size_t i = 0; i < n; i++)
+						if (!dst.put(p[i]))
+							return false;
+					return true;
+				}
+			}
+
+			// invalid input in replace mode becomes U+FFFD
+			template<class DST>
+			constexpr bool put_invalid(DST& dst, utf8_mode mode) {
+				return mode == utf8_mode::replace && put_utf8(dst, 0xFFFD);
+			}
+
+			// parse the 4 hex digits after a \u
+			template<class CTX>
+			constexpr bool parse_hex4(uint32_t& cp, CTX& ctx) {
+				cp = 0;
+				for (int i = 0; i < 4; i++) {
+					char c = ctx.get();
+					if ('0' <= c && c <= '9')
+						cp = cp * 16 + (c - '0');
+					else if ('a' <= c && c <= 'f')
+						cp = cp * 16 + (c - 'a' + 10);
+					else if ('A' <= c && c <= 'F')
+						cp = cp * 16 + (c - 'A' + 10);
+					else
+						return false;
+				}
+				return true;
+			}
+
+			template<class DST, class CTX>
+			constexpr bool parse_escape(unsigned char c, DST& dst, CTX& ctx, utf8_mode mode);
+
+			// decode a \u escape (the \u is already consumed), surrogate pairs are combined
+			template<class DST, class CTX>
+			constexpr bool parse_unicode_escape(DST& dst, CTX& ctx, utf8_mode mode) {
+				uint32_t cp = 0;
+				if (!parse_hex4(cp, ctx))
+					return false;
+				while (0xD800 <= cp && cp <= 0xDBFF) {
+					// high surrogate, must be followed by an escaped low surrogate
+					if (ctx.peek() == '\\') {
+						ctx.ignore();
+						unsigned char e = ctx.get();
+						if (e != 'u') {
+							// unpaired high surrogate followed by another escape
+							if (!(mode == utf8_mode::pass ? put_utf8(dst, cp) : put_invalid(dst, mode)))
+								return false;
+							return parse_escape(e, dst, ctx, mode);
+						}
+						uint32_t lo = 0;
+						if (!parse_hex4(lo, ctx))
+							return false;
+						if (0xDC00 <= lo && lo <= 0xDFFF)
+							return put_utf8(dst, 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00));
+						// unpaired high surrogate, emit it and continue with the next escape
+						if (!(mode == utf8_mode::pass ? put_utf8(dst, cp) : put_invalid(dst, mode)))
+							return false;
+						cp = lo;
+						continue;
+					}
+					return mode == utf8_mode::pass ? put_utf8(dst, cp) : put_invalid(dst, mode);
+				}
+				if (0xDC00 <= cp && cp <= 0xDFFF && mode != utf8_mode::pass)
+					return put_invalid(dst, mode);
+				return put_utf8(dst, cp);
+			}
+
+			// decode the escape after a backslash
 			template<class DST, class CTX>
-			inline bool parse_string(DST& dst, CTX& ctx) {
+			constexpr bool parse_escape(unsigned char c, DST& dst, CTX& ctx, utf8_mode mode) {
+				switch(c) {
+				case '\"' :
+				case '\\' :
+				case '/' :
+					return dst.put(c);
+				case 'b' :
+					return dst.put('\b');
+				case 'f' :
+					return dst.put('\f');
+				case 'n' :
+					return dst.put('\n');
+				case 'r' :
+					return dst.put('\r');
+				case 't' :
+					return dst.put('\t');
+				case 'u' :
+					return parse_unicode_escape(dst, ctx, mode);
+				default:
+					return false;
+				}
+			}
+
+			// decode a single multibyte utf-8 sequence from a character by character context
+			template<class DST, class CTX>
+			constexpr bool parse_utf8_seq(unsigned char lead, DST& dst, CTX& ctx, utf8_mode mode) {
+				int len = utf8_len(lead);
+				char seq[4] = { (char)lead };
+				int k = 1;
+				while (k < len && !ctx.eof() && utf8_cont(lead, (unsigned char)ctx.peek(), k))
+					seq[k++] = ctx.get();
+				if (len == 0 || k < len)
+					return put_invalid(dst, mode);
+				return put_run(dst, seq, len);
+			}
+
+			template<class DST, class CTX>
+			constexpr bool parse_string(DST& dst, CTX& ctx) {
 				if (!skip_space(ctx))
 					return false;
 				if (ctx.get() != '\"')
 					return false;
-				while (ctx.peek() != '\"') {
+				const utf8_mode mode = ctx_utf8(ctx);
+				while (true) {
+					if constexpr (has_span<CTX>::value) {
+						// contiguous input, copy all plain runs in bulk and validate them in place
+						const char* p = ctx.cur();
+						size_t valid = 0;
+						size_t n = mode == utf8_mode::pass ? scan_string(p, ctx.end()) : scan_string_utf8(p, ctx.end(), valid);
+						if (n) {
+							size_t bad = 0;
+							size_t ok = mode == utf8_mode::pass || valid == n ? n : valid + utf8_validate(p + valid, n - valid, bad);
+							if (!put_run(dst, p, ok))
+								return false;
+							ctx.advance(ok);
+							if (bad) {
+								if (!put_invalid(dst, mode))
+									return false;
+								ctx.advance(bad);
+							}
+							if (ok + bad < n)
+								continue;
+						}
+					}
 					if (ctx.eof())
 						return false;
-					auto c = ctx.get();
-					if (c == '\\') {
-						c = ctx.get();
-						switch(c) {
-						case '\"' :
-						case '\\' :
-						case '/' :
-							if (!dst.put(c))
-								return false;
-							continue;
-						case 'b' :
-							if (!dst.put('\b'))
-								return false;
-							continue;
-						case 'f' :
-							if (!dst.put('\f'))
-								return false;
-							continue;
-						case 'n' :
-							if (!dst.put('\n'))
-								return false;
-							continue;
-						case 'r' :
-							if (!dst.put('\r'))
-								return false;
-							continue;
-						case 't' :
-							if (!dst.put('\t'))
-								return false;
-							continue;
-						default:
-							printf("Parse nonimpl-err with %c\n",c);
+					unsigned char c = ctx.get();
+					if (c == '\"') {
+						break;
+					} else if (c == '\\') {
+						if (!parse_escape(ctx.get(), dst, ctx, mode))
+							return false;
+					} else if (c >= 0x80 && mode != utf8_mode::pass) {
+						if (!parse_utf8_seq(c, dst, ctx, mode))
 							return false;
-						}
-						// TODO
-						//abort();
 					} else {
 						if (!dst.put(c))
 							return false;
 					}
 				}
 				dst.term();
-				if (ctx.get() != '\"')
-					return false;
 				return true;
 			}
 
@@ -168,16 +724,23 @@ namespace rpoco2 {
 				CT* dest;
 				size_t index = 0;
 
-				void reset() {
+				constexpr void reset() {
 					index = 0;
 				}
-				bool put(CT v) {
+				constexpr bool put(CT v) {
 					if (index >= L - 1)
 						return false;
 					dest[index++] = v;
 					return true;
 				}
-				void term() {
+				constexpr bool append(const CT* v, size_t n) {
+					if (index + n > L - 1)
+						return false;
+					for (size_t i = 0; i < n; i++)
+						dest[index++] = v[i];
+					return true;
+				}
+				constexpr void term() {
 					dest[index] = 0;
 				}
 			};
@@ -189,7 +752,7 @@ namespace rpoco2 {
 
 			// Parseobject expects a keyparser, memberparser and context as inputs
 			template<class KP, class MP, class CTX>
-			bool parse_object(KP& kp, MP& mp, CTX& ctx) {
+			constexpr bool parse_object(KP& kp, MP& mp, CTX& ctx) {
 				// ignore possible spaces before the object
 				if (!skip_space(ctx))
 					return false;
@@ -234,47 +797,116 @@ namespace rpoco2 {
 				}
 			}
 
-			template<class T, class CTX>
-			struct parser {
-				static bool parse(T& t, CTX& ctx) {
-					// get type-info
-					const auto* ati = t.rpoco2_type_info_get();
-					// make a fixed 100 byte buffer for keys
-					char symname[100];
-					string_writer<decltype(symname)> sw{ symname };
-
-					auto keyFn = [&sw](CTX& ctx) {
-						// this keyparser re-uses the buffer and asks the parse_string function to fill it in.
-						sw.reset();
-						return parse_string(sw, ctx);
-					};
-
-					auto valFn = [&sw, &ati, &t](CTX& ctx) {
-						// after the keyparser has completed we can issue the appropriate memberparser (depending on our datatype!)
-						bool ok = true;
-						// we create a locator that will execute the type-specific parser.
-						auto symloc = ati->locator(&t, [&ok, &ctx](auto& name, auto& dv) {
-							// dispatch the type-specific parser
-							ok = parser<std::remove_reference_t<decltype(dv)>, CTX>::parse(dv, ctx);
-							});
-						if (!symloc(sw.dest, sw.index)) {
-							// UNKNOWN/Freewheel PARSING NOT YET IMPL TODO
-							//printf("ERR, NEED NULL PARSER\n");
-							//abort();
-							//return false;
-							return parse_ignore(ctx);
+			// resolves an object key to a member index of the type-info TI (-1 for unknown keys) without copying it,
+			// plain keys in contiguous input are looked up in place and others are streamed into a matcher
+			template<class TI, class CTX>
+			constexpr bool parse_key(const TI& ti, int& idx, CTX& ctx) {
+				if constexpr (has_span<CTX>::value) {
+					if (!skip_space(ctx))
+						return false;
+					const char* p = ctx.cur();
+					if (*p == '\"') {
+						size_t valid = 0;
+						size_t n = scan_string_utf8(p + 1, ctx.end(), valid);
+						size_t bad = 0;
+						if (p + 1 + n < ctx.end() && p[1 + n] == '\"' && (ctx_utf8(ctx) == utf8_mode::pass || valid == n || valid + utf8_validate(p + 1 + valid, n - valid, bad) == n)) {
+							idx = ti.find(p + 1, n);
+							ctx.advance(n + 2);
+							return true;
 						}
-						return ok;
-					};
+					}
+				}
+				struct {
+					typename TI::matcher m;
+					constexpr void reset() {
+						m.reset();
+					}
+					constexpr bool put(char c) {
+						m.feed(c);
+						return true;
+					}
+					constexpr bool append(const char* p, size_t n) {
+						for (size_t i = 0; i < n; i++)
+							m.feed(p[i]);
+						return true;
+					}
+					constexpr void term() {}
+				} kw{ typename TI::matcher(&ti) };
+				if (!parse_string(kw, ctx))
+					return false;
+				idx = kw.m.index();
+				return true;
+			}
+
+			template<class T, class CTX>
+			struct parser;
+
+			// parses an object into the members of t described by the type-info ti
+			template<class TI, class T, class CTX>
+			bool parse_members(const TI& ti, T& t, CTX& ctx) {
+				// declaration index of the member for the current key
+				int idx = -1;
+
+				auto keyFn = [&idx, &ti](CTX& ctx) {
+					return parse_key(ti, idx, ctx);
+				};
+
+				auto valFn = [&idx, &ti, &t](CTX& ctx) {
+					// unknown members are skipped
+					if (idx < 0)
+						return parse_ignore(ctx);
+					bool ok = true;
+					// dispatch the type-specific parser for the member
+					ti.member_apply(&t, idx, [&ok, &ctx](auto&, auto& dv) {
+						ok = parser<std::remove_reference_t<decltype(dv)>, CTX>::parse(dv, ctx);
+						});
+					return ok;
+				};
 
-					// now parse the object
-					return parse_object(
-						keyFn, valFn, ctx);
+				// now parse the object
+				return parse_object(
+					keyFn, valFn, ctx);
+			}
+
+			template<class T, class CTX, std::size_t ... I>
+			constexpr bool parse_member_at(T& t, int idx, CTX& ctx, std::index_sequence<I...>) {
+				using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+				bool ok = false;
+				((idx == (int)I ? (ok = parser<typename TI::template member_type<I>, CTX>::parse(t.*(impl2::tinfo<T>.template member_ptr<I>()), ctx), true) : false) || ...);
+				return ok;
+			}
+
+			// parse_members for constant evaluation, the member dispatch is a compile-time chain instead of a function table
+			template<class T, class CTX>
+			constexpr bool parse_members_constant(T& t, CTX& ctx) {
+				using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+				int idx = -1;
+
+				auto keyFn = [&idx](CTX& ctx) {
+					return parse_key(impl2::tinfo<T>, idx, ctx);
+				};
+
+				auto valFn = [&idx, &t](CTX& ctx) {
+					if (idx < 0)
+						return parse_ignore(ctx);
+					return parse_member_at(t, idx, ctx, std::make_index_sequence<TI::count>());
+				};
+
+				return parse_object(keyFn, valFn, ctx);
+			}
+
+			template<class T, class CTX>
+			struct parser {
+				static constexpr bool parse(T& t, CTX& ctx) {
+					if constexpr (is_constant_ctx<CTX>::value)
+						return parse_members_constant(t, ctx);
+					else
+						return parse_members(*t.rpoco2_type_info_get(), t, ctx);
 				}
 			};
 
 			template<class CTX>
-			int parse_peek(CTX& ctx) {
+			constexpr int parse_peek(CTX& ctx) {
 				if (!skip_space(ctx))
 					return 0;
 				char c = ctx.peek();
@@ -293,7 +925,7 @@ namespace rpoco2 {
 			}
 
 			template<typename MP,class CTX>
-			bool parse_array(MP& mp,CTX& ctx) {
+			constexpr bool parse_array(MP&& mp,CTX& ctx) {
 				if (!skip_space(ctx))
 					return false;
 				char c=ctx.get();
@@ -316,22 +948,32 @@ namespace rpoco2 {
 					} // else would have a ] and that will break after the while
 				}
 				ctx.ignore(); // eat ]
-				if (!skip_space(ctx)) return false;
 				return true;
 			}
 
 			template<typename T,size_t L, class CTX>
 			struct parser<T[L], CTX> {
-				static bool parse(T(&t)[L], CTX& ctx) {
+				static constexpr bool parse(T(&t)[L], CTX& ctx) {
 					return parse_array([&t](CTX& ctx,int idx){
+						if (idx >= (int)L)
+							return false;
 						return parser<T,CTX>::parse(t[idx],ctx);
 					},ctx);
 				}
 			};
 
+			template<typename T,size_t L, class CTX>
+			struct parser<std::array<T,L>, CTX> {
+				static constexpr bool parse(std::array<T,L>& t, CTX& ctx) {
+					return parse_array([&t](CTX& ctx,int idx){
+						return idx < (int)L && parser<T,CTX>::parse(t[idx],ctx);
+					},ctx);
+				}
+			};
+
 			template<size_t L, class CTX>
 			struct parser<char[L], CTX> {
-				static bool parse(char(&t)[L], CTX& ctx) {
+				static constexpr bool parse(char(&t)[L], CTX& ctx) {
 					string_writer<char[L]> sw{ t };
 					return parse_string(sw, ctx);
 				}
@@ -339,28 +981,28 @@ namespace rpoco2 {
 
 			template<class CTX>
 			struct parser<float, CTX> {
-				static bool parse(float& t, CTX& ctx) {
+				static constexpr bool parse(float& t, CTX& ctx) {
 					return parse_number<float, CTX>(t, ctx);
 				}
 			};
 			template<class CTX>
 			struct parser<double, CTX> {
-				static bool parse(double& t, CTX& ctx) {
+				static constexpr bool parse(double& t, CTX& ctx) {
 					return parse_number<double, CTX>(t, ctx);
 				}
 			};
 
 			template<class CTX>
 			struct parser<int, CTX> {
-				static bool parse(int& t, CTX& ctx) {
+				static constexpr bool parse(int& t, CTX& ctx) {
 					return parse_number<int, CTX>(t, ctx);
 				}
 			};
 
 
 			template<typename CTX>
-			bool parse_known(CTX& ctx,const char *tok) {
-				char rc;
+			constexpr bool parse_known(CTX& ctx,const char *tok) {
+				char rc = 0;
 				while(rc=*(tok++)) {
 					char c=ctx.get();
 					if (rc!=c)
@@ -371,7 +1013,7 @@ namespace rpoco2 {
 
 			template<class CTX>
 			struct parser<bool, CTX> {
-				static bool parse(bool& v, CTX& ctx) {
+				static constexpr bool parse(bool& v, CTX& ctx) {
 					auto pv = parse_peek(ctx);
 					if (pv == 't') {
 						v = true;
@@ -384,7 +1026,7 @@ namespace rpoco2 {
 			};
 
 			template<typename CTX>
-			bool parse_ignore(CTX& ctx) {
+			constexpr bool parse_ignore(CTX& ctx) {
 				int ty = parse_peek(ctx);
 				switch(ty) {
 				case '{': {
@@ -402,14 +1044,15 @@ namespace rpoco2 {
 				case 'n' :
 					return parse_known(ctx,"null");
 				case '+' : {
-						double t;
+						double t = 0;
 						return parse_number(t,ctx);
 					}
 				case '\"': {
 						struct {
-							void reset() {}
-							bool put(int c) { return true; }
-							void term() {}
+							constexpr void reset() {}
+							constexpr bool put(int) { return true; }
+							constexpr bool append(const char*, size_t) { return true; }
+							constexpr void term() {}
 						} nsw;
 						return parse_string(nsw,ctx);
 					}
@@ -421,18 +1064,15 @@ namespace rpoco2 {
 
 		}
 
-		template<class T>
-		bool parse(T& dest, const char* src, int len = -1) {
-			struct SA {
+		namespace impl {
+			// parsing context over a contiguous buffer
+			struct span_ctx {
 				const char* src;
 				int len;
+				parse_options options;
 				int idx = 0;
 				inline bool eof() {
-					if (len < 0) {
-						return !src[idx];
-					} else {
-						return idx < len;
-					}
+					return idx >= len;
 				}
 				inline char peek() {
 					if (eof())
@@ -447,9 +1087,76 @@ namespace rpoco2 {
 				inline void ignore() {
 					idx++;
 				}
-			}sa{ src,len };
+				inline const char* cur() {
+					return src + idx;
+				}
+				inline const char* end() {
+					return src + len;
+				}
+				inline void advance(size_t n) {
+					idx += (int)n;
+				}
+			};
+		}
+
+		namespace impl {
+			// parsing context for constant evaluation, it has no raw byte access so all scanning stays scalar
+			struct constant_ctx {
+				static constexpr bool constant = true;
+				std::string_view src;
+				parse_options options;
+				size_t idx = 0;
+				constexpr bool eof() {
+					return idx >= src.size();
+				}
+				constexpr char peek() {
+					if (eof())
+						return 0;
+					return src[idx];
+				}
+				constexpr char get() {
+					if (eof())
+						return 0;
+					return src[idx++];
+				}
+				constexpr void ignore() {
+					idx++;
+				}
+			};
+		}
+
+		// parses a document at compile time, ie: constexpr auto cfg = json::parse_constexpr<Config>(R"({...})");
+		// T must be a literal type made of arithmetic types, bool, char arrays, arrays, std::array and RPOCO2 types.
+		// Invalid documents fail the constant evaluation (or throw when evaluated at runtime).
+		template<class T>
+		constexpr T parse_constexpr(std::string_view src, const parse_options& options = parse_options{}) {
+			T dest{};
+			impl::constant_ctx ctx{ src, options };
+			if (!impl::parser<T, impl::constant_ctx>::parse(dest, ctx))
+				throw std::invalid_argument("invalid json");
+			return dest;
+		}
+
+		template<class T>
+		bool parse(T& dest, const char* src, int len, const parse_options& options) {
+			impl::span_ctx sa{ src, len < 0 ? (int)strlen(src) : len, options };
 
-			return impl::parser<T, SA>::parse(dest, sa);
+			return impl::parser<T, impl::span_ctx>::parse(dest, sa);
+		}
+
+		template<class T>
+		bool parse(T& dest, const char* src, int len = -1) {
+			return parse(dest, src, len, parse_options{});
+		}
+
+		// std::pmr containers and shared_ptr's created while parsing allocate from resource (std::any values only
+		// with parse_options::pmr_dom),
+		// ie: a std::pmr::monotonic_buffer_resource per request that is released in one go
+		template<class T>
+		bool parse(T& dest, const char* src, int len, std::pmr::memory_resource* resource) {
+			parse_options options;
+			options.resource = resource;
+			return parse(dest, src, len, options);
 		}
 
 	}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "json.hpp"
+#include "columns.hpp"
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			// parses [ {T}, {T}, ... ] with every member written straight into its column
+			template<class T, class CTX>
+			struct parser<columns<T>, CTX> {
+				using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+				using member_fn = bool(*)(columns<T>& c, CTX& ctx);
+
+				template<std::size_t I>
+				static bool parse_member(columns<T>& c, CTX& ctx) {
+					using M = typename TI::template member_type<I>;
+					auto& col = c.template column<I>();
+					if constexpr (std::is_array_v<M> || std::is_same_v<M, bool>) {
+						// std::array and std::vector<bool> cells can't be handed out as an M&
+						M tmp{};
+						if (!parser<M, CTX>::parse(tmp, ctx))
+							return false;
+						if constexpr (std::is_array_v<M>)
+							std::copy(std::begin(tmp), std::end(tmp), col.back().begin());
+						else
+							col.back() = tmp;
+						return true;
+					} else {
+						return parser<M, CTX>::parse(col.back(), ctx);
+					}
+				}
+
+				template<std::size_t ... I>
+				static bool dispatch(columns<T>& c, int idx, CTX& ctx, std::index_sequence<I...>) {
+					static const member_fn fns[] = { &parse_member<I>... };
+					return fns[idx](c, ctx);
+				}
+
+				static bool parse(columns<T>& c, CTX& ctx) {
+					const auto* ati = T::rpoco2_type_info_get();
+					int idx = -1;
+
+					auto keyFn = [&idx, ati](CTX& ctx) {
+						return parse_key(*ati, idx, ctx);
+					};
+					auto valFn = [&c, &idx](CTX& ctx) {
+						if (idx < 0)
+							return parse_ignore(ctx);
+						return dispatch(c, idx, ctx, std::make_index_sequence<TI::count>());
+					};
+
+					c.clear();
+					return parse_array([&](CTX& ctx, int) {
+						// every record gets a row so the columns stay aligned, absent members keep their default
+						c.emplace_row();
+						return parse_object(keyFn, valFn, ctx);
+					}, ctx);
+				}
+			};
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "json.hpp"
+#include "fixed.hpp"
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			// strings that don't fit fail the parse
+			template<size_t N, class CTX>
+			struct parser<fixed_string<N>, CTX> {
+				static bool parse(fixed_string<N>& s, CTX& ctx) {
+					struct {
+						fixed_string<N>* ptr;
+						void reset() {
+							ptr->clear();
+						}
+						bool put(char c) {
+							return ptr->push_back(c);
+						}
+						bool append(const char* p, size_t n) {
+							return ptr->append(p, n);
+						}
+						void term() {}
+					}fsw;
+					fsw.ptr = &s;
+					fsw.reset();
+					return parse_string(fsw, ctx);
+				}
+			};
+
+			// arrays with more elements than the capacity fail the parse
+			template<typename T, size_t N, class CTX>
+			struct parser<fixed_vector<T, N>, CTX> {
+				static bool parse(fixed_vector<T, N>& v, CTX& ctx) {
+					v.clear();
+					auto fn = [&v](CTX& ctx, int) {
+						T* e = v.emplace_back();
+						if (!e)
+							return false;
+						return parser<T, CTX>::parse(*e, ctx);
+					};
+					return parse_array(
+						fn,
+						ctx
+					);
+				}
+			};
+		}
+	}
+}
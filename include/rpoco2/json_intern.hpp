@@ -0,0 +1,67 @@
+#pragma once
+
+#include "json.hpp"
+#include "intern.hpp"
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			template<class CTX>
+			struct parser<interned, CTX> {
+				static bool parse(interned& v, CTX& ctx) {
+					// strings without escapes in contiguous input arrive as a single append and are looked up
+					// straight from the input, anything else is assembled in a small stack buffer first
+					struct {
+						const char* direct = nullptr;
+						size_t len = 0;
+						char buf[128];
+						std::string spill;
+						bool copy() {
+							if (direct) {
+								if (len > sizeof(buf))
+									spill.assign(direct, len);
+								else
+									memcpy(buf, direct, len);
+								direct = nullptr;
+							}
+							return true;
+						}
+						void reset() {}
+						bool put(char c) {
+							return buffer(&c, 1);
+						}
+						bool append(const char* p, size_t n) {
+							// only contiguous contexts append straight from the input, others may append from temporaries
+							if (has_span<CTX>::value && !direct && len == 0) {
+								direct = p;
+								len = n;
+								return true;
+							}
+							return buffer(p, n);
+						}
+						bool buffer(const char* p, size_t n) {
+							copy();
+							if (len + n > sizeof(buf)) {
+								if (len <= sizeof(buf))
+									spill.assign(buf, len);
+								spill.append(p, n);
+							} else {
+								memcpy(buf + len, p, n);
+							}
+							len += n;
+							return true;
+						}
+						void term() {}
+						std::string_view view() const {
+							return direct ? std::string_view(direct, len) : len > sizeof(buf) ? std::string_view(spill) : std::string_view(buf, len);
+						}
+					} isw;
+					if (!parse_string(isw, ctx))
+						return false;
+					v = interned(isw.view());
+					return true;
+				}
+			};
+		}
+	}
+}
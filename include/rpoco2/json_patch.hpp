@@ -0,0 +1,196 @@
+#pragma once
+
+#include "json_std.hpp"
+
+// RFC 7386 merge patches applied in place, only the members present in the patch are touched
+// so the cost is proportional to the size of the patch and not the target.
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+
+			// null in a patch resets a member to its default value
+			template<class T>
+			void reset_value(T& t) {
+				if constexpr (std::is_array_v<T>) {
+					for (auto& e : t)
+						reset_value(e);
+				} else {
+					t = T{};
+				}
+			}
+
+			template<class T>
+			void move_value(T& dst, T& src) {
+				if constexpr (std::is_array_v<T>) {
+					for (size_t i = 0; i < std::extent_v<T>; i++)
+						move_value(dst[i], src[i]);
+				} else {
+					dst = std::move(src);
+				}
+			}
+
+			// values that aren't objects are replaced as a whole by the patch value
+			template<class T, class CTX, class = void>
+			struct patcher {
+				static bool patch(T& t, CTX& ctx) {
+					if (parse_peek(ctx) == 'n') {
+						reset_value(t);
+						return parse_known(ctx, "null");
+					}
+					// parse into a fresh value since fixed arrays only overwrite the elements present, a failed
+					// patch leaves t untouched
+					T tmp{};
+					if (!parser<T, CTX>::parse(tmp, ctx))
+						return false;
+					move_value(t, tmp);
+					return true;
+				}
+			};
+
+			// RPOCO2 objects, members present in the patch are patched recursively
+			template<class T, class CTX>
+			struct patcher<T, CTX, std::enable_if_t<impl2::is_rpoco_v<T>>> {
+				static bool patch(T& t, CTX& ctx) {
+					int pv = parse_peek(ctx);
+					if (pv == 'n') {
+						reset_value(t);
+						return parse_known(ctx, "null");
+					} else if (pv != '{') {
+						return false;
+					}
+					const auto* ati = t.rpoco2_type_info_get();
+					int idx = -1;
+
+					auto keyFn = [&idx, ati](CTX& ctx) {
+						return parse_key(*ati, idx, ctx);
+					};
+
+					auto valFn = [&idx, ati, &t](CTX& ctx) {
+						if (idx < 0)
+							return parse_ignore(ctx);
+						bool ok = true;
+						ati->member_apply(&t, idx, [&ok, &ctx](auto&, auto& dv) {
+							ok = patcher<std::remove_reference_t<decltype(dv)>, CTX>::patch(dv, ctx);
+							});
+						return ok;
+					};
+
+					return parse_object(keyFn, valFn, ctx);
+				}
+			};
+
+			// maps are patched per key, null erases the key
+			template<class TR, class KA, class V, class C, class A, class CTX>
+			struct patcher<std::map<std::basic_string<char, TR, KA>, V, C, A>, CTX> {
+				using key_type = std::basic_string<char, TR, KA>;
+				static bool patch(std::map<key_type, V, C, A>& m, CTX& ctx) {
+					int pv = parse_peek(ctx);
+					if (pv == 'n') {
+						m.clear();
+						return parse_known(ctx, "null");
+					} else if (pv != '{') {
+						return false;
+					}
+					key_type key(KA(m.get_allocator()));
+					auto keyFn = [&key](CTX& ctx) {
+						key.clear();
+						return parser<key_type, CTX>::parse(key, ctx);
+					};
+					auto valFn = [&key, &m](CTX& ctx) {
+						if (parse_peek(ctx) == 'n') {
+							m.erase(key);
+							return parse_known(ctx, "null");
+						}
+						return patcher<V, CTX>::patch(m[key], ctx);
+					};
+					return parse_object(keyFn, valFn, ctx);
+				}
+			};
+
+			template<class T, class CTX>
+			struct patcher<std::shared_ptr<T>, CTX> {
+				static bool patch(std::shared_ptr<T>& v, CTX& ctx) {
+					if (parse_peek(ctx) == 'n') {
+						v.reset();
+						return parse_known(ctx, "null");
+					}
+					if (!v) {
+						v = std::make_shared<T>();
+					} else if constexpr (std::is_copy_constructible_v<T>) {
+						// don't modify objects that other owners see
+						if (v.use_count() > 1)
+							v = std::make_shared<T>(*v);
+					}
+					return patcher<T, CTX>::patch(*v, ctx);
+				}
+			};
+
+			template<class T, class CTX>
+			struct patcher<std::unique_ptr<T>, CTX> {
+				static bool patch(std::unique_ptr<T>& v, CTX& ctx) {
+					if (parse_peek(ctx) == 'n') {
+						v.reset();
+						return parse_known(ctx, "null");
+					}
+					if (!v)
+						v = std::make_unique<T>();
+					return patcher<T, CTX>::patch(*v, ctx);
+				}
+			};
+
+			template<class T, class CTX>
+			struct patcher<std::optional<T>, CTX> {
+				static bool patch(std::optional<T>& v, CTX& ctx) {
+					if (parse_peek(ctx) == 'n') {
+						v.reset();
+						return parse_known(ctx, "null");
+					}
+					if (!v)
+						v.emplace();
+					return patcher<T, CTX>::patch(*v, ctx);
+				}
+			};
+
+			// dynamic values merge objects into objects and replace everything else
+			template<class CTX>
+			struct patcher<std::any, CTX> {
+				static bool patch(std::any& v, CTX& ctx) {
+					using obj = std::map<std::string, std::any>;
+					using pmr_obj = std::pmr::map<std::pmr::string, std::any>;
+					if (parse_peek(ctx) != '{')
+						return parser<std::any, CTX>::parse(v, ctx);
+					if (v.type() == typeid(obj))
+						return patcher<obj, CTX>::patch(std::any_cast<obj&>(v), ctx);
+					if (v.type() == typeid(pmr_obj))
+						return patcher<pmr_obj, CTX>::patch(std::any_cast<pmr_obj&>(v), ctx);
+					// other values are replaced by the patch applied to an empty object so nulls in it are dropped
+					if (ctx_pmr_dom(ctx)) {
+						std::pmr::memory_resource* res = ctx_resource(ctx);
+						return patch_fresh(v, pmr_obj(res ? res : std::pmr::get_default_resource()), ctx);
+					}
+					return patch_fresh(v, obj(), ctx);
+				}
+				template<class OBJ>
+				static bool patch_fresh(std::any& v, OBJ&& o, CTX& ctx) {
+					if (!patcher<OBJ, CTX>::patch(o, ctx))
+						return false;
+					v = std::move(o);
+					return true;
+				}
+			};
+		}
+
+		template<class T>
+		bool merge_patch(T& dest, const char* src, int len, const parse_options& options) {
+			impl::span_ctx sa{ src, len < 0 ? (int)strlen(src) : len, options };
+
+			return impl::patcher<T, impl::span_ctx>::patch(dest, sa);
+		}
+
+		template<class T>
+		bool merge_patch(T& dest, const char* src, int len = -1) {
+			return merge_patch(dest, src, len, parse_options{});
+		}
+	}
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "json.hpp"
+#include "json_std_string.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Table driven parsing, each RPOCO2 type is described by a constant descriptor table (access function, kind,
+// capacity, nested table) that a single shared interpreter walks. Only members of kinds the interpreter doesn't
+// handle instantiate a parser, and those are shared per member type instead of per RPOCO2 type.
+// Vectors, maps, optionals and smart pointers of RPOCO2 types parse their elements through the element's table.
+// The fully templated json::parse is still the fastest path for the hottest types.
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			enum class plan_kind : unsigned char {
+				other = 0,  // parsed by the member's parse function
+				int32,
+				float32,
+				float64,
+				boolean,
+				chars,      // zero terminated char[size]
+				object      // nested RPOCO2 type, parsed by the nested plan
+			};
+
+			struct type_plan;
+
+			struct member_plan {
+				void* (*access)(void* obj);
+				plan_kind kind;
+				std::size_t size;
+				const type_plan* nested;
+				bool (*parse)(void* dst, span_ctx& ctx);
+			};
+
+			// members are in declaration order, snames maps the sorted names to them
+			struct type_plan {
+				const impl2::nameidx* snames;
+				int count;
+				const member_plan* members;
+
+				class matcher : public impl2::name_matcher {
+				public:
+					matcher(const type_plan* tp) : impl2::name_matcher(tp->snames, tp->count) {}
+				};
+
+				int find(const char* n, size_t len) const {
+					return impl2::find_name(snames, count, std::string_view(n, len));
+				}
+			};
+
+			// string writer for char arrays with a runtime capacity
+			struct chars_writer {
+				char* dest;
+				size_t cap;
+				size_t index = 0;
+
+				void reset() {
+					index = 0;
+				}
+				bool put(char v) {
+					if (index >= cap - 1)
+						return false;
+					dest[index++] = v;
+					return true;
+				}
+				bool append(const char* v, size_t n) {
+					if (index + n > cap - 1)
+						return false;
+					memcpy(dest + index, v, n);
+					index += n;
+					return true;
+				}
+				void term() {
+					dest[index] = 0;
+				}
+			};
+
+			// the shared interpreter
+			inline bool run_plan(const type_plan& tp, void* obj, span_ctx& ctx) {
+				int idx = -1;
+
+				auto keyFn = [&idx, &tp](span_ctx& ctx) {
+					return parse_key(tp, idx, ctx);
+				};
+
+				auto valFn = [&idx, &tp, obj](span_ctx& ctx) {
+					if (idx < 0)
+						return parse_ignore(ctx);
+					const member_plan& mp = tp.members[idx];
+					void* dst = mp.access(obj);
+					switch (mp.kind) {
+					case plan_kind::int32:
+						return parse_number(*static_cast<int*>(dst), ctx);
+					case plan_kind::float32:
+						return parse_number(*static_cast<float*>(dst), ctx);
+					case plan_kind::float64:
+						return parse_number(*static_cast<double*>(dst), ctx);
+					case plan_kind::boolean:
+						return parser<bool, span_ctx>::parse(*static_cast<bool*>(dst), ctx);
+					case plan_kind::chars: {
+						chars_writer cw{ static_cast<char*>(dst), mp.size };
+						return parse_string(cw, ctx);
+					}
+					case plan_kind::object:
+						return run_plan(*mp.nested, dst, ctx);
+					default:
+						return mp.parse(dst, ctx);
+					}
+				};
+
+				return parse_object(keyFn, valFn, ctx);
+			}
+
+			template<class T>
+			const type_plan* plan_of();
+
+			// RPOCO2 types and containers that (eventually) hold them
+			template<class T>
+			struct plan_nested : impl2::is_rpoco<T> {};
+			template<class T, class A>
+			struct plan_nested<std::vector<T, A>> : plan_nested<T> {};
+			template<class TR, class KA, class V, class C, class A>
+			struct plan_nested<std::map<std::basic_string<char, TR, KA>, V, C, A>> : plan_nested<V> {};
+			template<class T>
+			struct plan_nested<std::optional<T>> : plan_nested<T> {};
+			template<class T>
+			struct plan_nested<std::shared_ptr<T>> : plan_nested<T> {};
+			template<class T>
+			struct plan_nested<std::unique_ptr<T>> : plan_nested<T> {};
+
+			// values of members the interpreter doesn't handle, RPOCO2 types inside containers are parsed
+			// through their plan and everything else by its parser
+			template<class M, class = void>
+			struct plan_value {
+				static bool parse(M& v, span_ctx& ctx) {
+					return parser<M, span_ctx>::parse(v, ctx);
+				}
+			};
+			template<class M>
+			struct plan_value<M, std::enable_if_t<impl2::is_rpoco_v<M>>> {
+				static bool parse(M& v, span_ctx& ctx) {
+					return run_plan(*plan_of<M>(), &v, ctx);
+				}
+			};
+			template<class T, class A>
+			struct plan_value<std::vector<T, A>, std::enable_if_t<plan_nested<T>::value>> {
+				static bool parse(std::vector<T, A>& v, span_ctx& ctx) {
+					v.clear();
+					adopt_resource(v, ctx);
+					return parse_array([&v](span_ctx& ctx, int) {
+						v.emplace_back();
+						return plan_value<T>::parse(v.back(), ctx);
+					}, ctx);
+				}
+			};
+			template<class TR, class KA, class V, class C, class A>
+			struct plan_value<std::map<std::basic_string<char, TR, KA>, V, C, A>, std::enable_if_t<plan_nested<V>::value>> {
+				using key_type = std::basic_string<char, TR, KA>;
+				static bool parse(std::map<key_type, V, C, A>& v, span_ctx& ctx) {
+					v.clear();
+					adopt_resource(v, ctx);
+					key_type key(KA(v.get_allocator()));
+					auto keyFn = [&key](span_ctx& ctx) {
+						return parser<key_type, span_ctx>::parse(key, ctx);
+					};
+					auto valFn = [&key, &v](span_ctx& ctx) {
+						return plan_value<V>::parse(v[key], ctx);
+					};
+					return parse_object(keyFn, valFn, ctx);
+				}
+			};
+			template<class T>
+			struct plan_value<std::optional<T>, std::enable_if_t<plan_nested<T>::value>> {
+				static bool parse(std::optional<T>& v, span_ctx& ctx) {
+					auto peek = parse_peek(ctx);
+					if (!peek)
+						return false;
+					if (peek == 'n') {
+						v.reset();
+						return parse_known(ctx, "null");
+					}
+					v.emplace();
+					return plan_value<T>::parse(*v, ctx);
+				}
+			};
+			template<class T>
+			struct plan_value<std::shared_ptr<T>, std::enable_if_t<plan_nested<T>::value>> {
+				static bool parse(std::shared_ptr<T>& v, span_ctx& ctx) {
+					auto peek = parse_peek(ctx);
+					if (!peek)
+						return false;
+					if (peek == 'n')
+						return parse_known(ctx, "null");
+					if (auto* res = ctx_resource(ctx))
+						v = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(res));
+					else
+						v = std::make_shared<T>();
+					return plan_value<T>::parse(*v, ctx);
+				}
+			};
+			template<class T>
+			struct plan_value<std::unique_ptr<T>, std::enable_if_t<plan_nested<T>::value>> {
+				static bool parse(std::unique_ptr<T>& v, span_ctx& ctx) {
+					auto peek = parse_peek(ctx);
+					if (!peek)
+						return false;
+					if (peek == 'n') {
+						v.reset();
+						return parse_known(ctx, "null");
+					}
+					v = std::make_unique<T>();
+					return plan_value<T>::parse(*v, ctx);
+				}
+			};
+
+			template<class M>
+			bool plan_parse_other(void* dst, span_ctx& ctx) {
+				return plan_value<M>::parse(*static_cast<M*>(dst), ctx);
+			}
+
+			template<class T>
+			struct plan_table;
+
+			template<class T, std::size_t I>
+			constexpr member_plan make_member_plan() {
+				using M = typename std::remove_const_t<decltype(impl2::tinfo<T>)>::template member_type<I>;
+				member_plan rv{ &impl2::member_access<T, I>, plan_kind::other, sizeof(M), nullptr, nullptr };
+				if constexpr (std::is_same_v<M, int>) {
+					rv.kind = plan_kind::int32;
+				} else if constexpr (std::is_same_v<M, float>) {
+					rv.kind = plan_kind::float32;
+				} else if constexpr (std::is_same_v<M, double>) {
+					rv.kind = plan_kind::float64;
+				} else if constexpr (std::is_same_v<M, bool>) {
+					rv.kind = plan_kind::boolean;
+				} else if constexpr (std::is_array_v<M> && std::is_same_v<std::remove_extent_t<M>, char>) {
+					rv.kind = plan_kind::chars;
+					rv.size = std::extent_v<M>;
+				} else if constexpr (impl2::is_rpoco_v<M>) {
+					rv.kind = plan_kind::object;
+					rv.nested = &plan_table<M>::plan;
+				} else {
+					rv.parse = &plan_parse_other<M>;
+				}
+				return rv;
+			}
+
+			template<class T, std::size_t ... I>
+			constexpr std::array<member_plan, sizeof...(I)> make_member_plans(std::index_sequence<I...>) {
+				return { make_member_plan<T, I>()... };
+			}
+
+			// the descriptor table of an RPOCO2 type, a compile-time constant
+			template<class T>
+			struct plan_table {
+				static constexpr std::size_t count = std::remove_const_t<decltype(impl2::tinfo<T>)>::count;
+				static constexpr std::array<member_plan, count> members = make_member_plans<T>(std::make_index_sequence<count>());
+				static constexpr type_plan plan{ impl2::tinfo<T>.sorted_names().data(), (int)count, members.data() };
+			};
+
+			template<class T>
+			const type_plan* plan_of() {
+				return &plan_table<T>::plan;
+			}
+		}
+
+		// parses through the descriptor table of T and the shared interpreter
+		template<class T>
+		bool parse_planned(T& dest, const char* src, int len, const parse_options& options) {
+			impl::span_ctx sa{ src, len < 0 ? (int)strlen(src) : len, options };
+
+			return impl::run_plan(*impl::plan_of<T>(), &dest, sa);
+		}
+
+		template<class T>
+		bool parse_planned(T& dest, const char* src, int len = -1) {
+			return parse_planned(dest, src, len, parse_options{});
+		}
+	}
+}
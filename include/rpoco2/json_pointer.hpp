@@ -0,0 +1,394 @@
+#pragma once
+
+#include "rpoco.hpp"
+#include "fixed.hpp"
+
+#include <cstdint>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+
+// JSON Pointers (RFC 6901) compiled against a type, ie: json::pointer<Order> p("/items/3/price");
+// Compiling resolves every reference token once into a chain of steps, member (of standard layout types) and
+// fixed array accesses fold into constant offsets and only dynamic containers (vectors, maps, optionals and smart
+// pointers) need a call.
+
+namespace rpoco2 {
+	namespace json {
+
+		// a type-erased reference to the value a pointer resolved to
+		struct value_ref {
+			void* ptr;
+			const std::type_info* type;
+
+			explicit operator bool() const {
+				return ptr != nullptr;
+			}
+			template<class V>
+			V* get() const {
+				return ptr && *type == typeid(V) ? static_cast<V*>(ptr) : nullptr;
+			}
+		};
+
+		namespace impl {
+			struct pointer_step {
+				void* (*deref)(void* p, const pointer_step& s);   // applied first if present
+				size_t index;
+				std::string key;
+				size_t offset;                                      // added after the deref
+			};
+
+			struct pointer_node {
+				const std::type_info* type;
+				// appends the steps for one reference token, returns the node of the referenced value or null
+				const pointer_node* (*resolve)(std::string_view token, std::vector<pointer_step>& steps);
+				// assigns a value of src_type (one of pointer_sources) converted to the node type
+				bool (*assign)(void* dst, const void* src, const std::type_info& src_type);
+			};
+
+			template<class T>
+			const pointer_node* pointer_node_of();
+
+			inline void pointer_add_offset(std::vector<pointer_step>& steps, size_t offset) {
+				if (steps.empty())
+					steps.push_back(pointer_step{ nullptr, 0, std::string(), 0 });
+				steps.back().offset += offset;
+			}
+
+			// array indices are decimal without leading zeros
+			inline bool pointer_index(std::string_view token, size_t& idx) {
+				if (token.empty() || (token.size() > 1 && token[0] == '0'))
+					return false;
+				idx = 0;
+				for (char c : token) {
+					if (c < '0' || '9' < c)
+						return false;
+					size_t d = c - '0';
+					// indices past SIZE_MAX would wrap around to a different element
+					if (idx > (SIZE_MAX - d) / 10)
+						return false;
+					idx = idx * 10 + d;
+				}
+				return true;
+			}
+
+			template<class T, std::size_t I>
+			const pointer_node* pointer_member(std::vector<pointer_step>& steps) {
+				using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+				if constexpr (std::is_standard_layout_v<T>) {
+					pointer_add_offset(steps, impl2::member_offset(impl2::tinfo<T>.template member_ptr<I>()));
+				} else {
+					steps.push_back(pointer_step{ [](void* p, const pointer_step&) -> void* {
+						return impl2::member_access<T, I>(p);
+					}, 0, std::string(), 0 });
+				}
+				return pointer_node_of<typename TI::template member_type<I>>();
+			}
+
+			template<class T, std::size_t ... I>
+			const pointer_node* pointer_member_at(int idx, std::vector<pointer_step>& steps, std::index_sequence<I...>) {
+				using fnptr = const pointer_node* (*)(std::vector<pointer_step>&);
+				static const fnptr fns[] = { &pointer_member<T, I>... };
+				return fns[idx](steps);
+			}
+
+			template<class T>
+			const pointer_node* pointer_resolve(std::string_view token, std::vector<pointer_step>& steps) {
+				if constexpr (impl2::is_rpoco_v<T>) {
+					using TI = std::remove_const_t<decltype(impl2::tinfo<T>)>;
+					int idx = impl2::tinfo<T>.find(token.data(), token.size());
+					if (idx < 0)
+						return nullptr;
+					return pointer_member_at<T>(idx, steps, std::make_index_sequence<TI::count>());
+				} else if constexpr (std::is_array_v<T>) {
+					size_t idx;
+					if (!pointer_index(token, idx) || idx >= std::extent_v<T>)
+						return nullptr;
+					pointer_add_offset(steps, idx * sizeof(std::remove_extent_t<T>));
+					return pointer_node_of<std::remove_extent_t<T>>();
+				} else {
+					return nullptr;
+				}
+			}
+
+			template<class T, size_t L>
+			const pointer_node* pointer_resolve_array(std::string_view token, std::vector<pointer_step>& steps) {
+				size_t idx;
+				if (!pointer_index(token, idx) || idx >= L)
+					return nullptr;
+				pointer_add_offset(steps, idx * sizeof(T));
+				return pointer_node_of<T>();
+			}
+
+			template<class T, class A>
+			const pointer_node* pointer_resolve_vector(std::string_view token, std::vector<pointer_step>& steps) {
+				size_t idx;
+				if (!pointer_index(token, idx))
+					return nullptr;
+				steps.push_back(pointer_step{ [](void* p, const pointer_step& s) -> void* {
+					auto& v = *static_cast<std::vector<T, A>*>(p);
+					return s.index < v.size() ? &v[s.index] : nullptr;
+				}, idx, std::string(), 0 });
+				return pointer_node_of<T>();
+			}
+
+			template<class T, size_t N>
+			const pointer_node* pointer_resolve_fixed_vector(std::string_view token, std::vector<pointer_step>& steps) {
+				size_t idx;
+				if (!pointer_index(token, idx) || idx >= N)
+					return nullptr;
+				steps.push_back(pointer_step{ [](void* p, const pointer_step& s) -> void* {
+					auto& v = *static_cast<fixed_vector<T, N>*>(p);
+					return s.index < v.size() ? &v[s.index] : nullptr;
+				}, idx, std::string(), 0 });
+				return pointer_node_of<T>();
+			}
+
+			// maps with std::string or std::pmr::string keys
+			template<class K, class V, class C, class A>
+			const pointer_node* pointer_resolve_map(std::string_view token, std::vector<pointer_step>& steps) {
+				steps.push_back(pointer_step{ [](void* p, const pointer_step& s) -> void* {
+					auto& m = *static_cast<std::map<K, V, C, A>*>(p);
+					typename std::map<K, V, C, A>::iterator it;
+					if constexpr (std::is_same_v<K, std::string>)
+						it = m.find(s.key);
+					else
+						it = m.find(K(s.key.data(), s.key.size(), m.get_allocator()));
+					return it != m.end() ? &it->second : nullptr;
+				}, 0, std::string(token), 0 });
+				return pointer_node_of<V>();
+			}
+
+			// optionals and smart pointers are transparent, the token applies to the contained value
+			template<class P, class T>
+			const pointer_node* pointer_resolve_nullable(std::string_view token, std::vector<pointer_step>& steps) {
+				steps.push_back(pointer_step{ [](void* p, const pointer_step&) -> void* {
+					auto& v = *static_cast<P*>(p);
+					return v ? &*v : nullptr;
+				}, 0, std::string(), 0 });
+				return pointer_node_of<T>()->resolve(token, steps);
+			}
+
+			template<class T>
+			struct pointer_resolver {
+				static constexpr auto fn = &pointer_resolve<T>;
+			};
+			template<class T, size_t L>
+			struct pointer_resolver<std::array<T, L>> {
+				static constexpr auto fn = &pointer_resolve_array<T, L>;
+			};
+			template<class T, class A>
+			struct pointer_resolver<std::vector<T, A>> {
+				static constexpr auto fn = &pointer_resolve_vector<T, A>;
+			};
+			// vector<bool> elements aren't addressable, pointers can end at the vector but not go into it
+			template<class A>
+			struct pointer_resolver<std::vector<bool, A>> {
+				static constexpr auto fn = &pointer_resolve<std::vector<bool, A>>;
+			};
+			template<class T, size_t N>
+			struct pointer_resolver<fixed_vector<T, N>> {
+				static constexpr auto fn = &pointer_resolve_fixed_vector<T, N>;
+			};
+			template<class TR, class KA, class V, class C, class A>
+			struct pointer_resolver<std::map<std::basic_string<char, TR, KA>, V, C, A>> {
+				static constexpr auto fn = &pointer_resolve_map<std::basic_string<char, TR, KA>, V, C, A>;
+			};
+			template<class T>
+			struct pointer_resolver<std::shared_ptr<T>> {
+				static constexpr auto fn = &pointer_resolve_nullable<std::shared_ptr<T>, T>;
+			};
+			template<class T, class D>
+			struct pointer_resolver<std::unique_ptr<T, D>> {
+				static constexpr auto fn = &pointer_resolve_nullable<std::unique_ptr<T, D>, T>;
+			};
+			template<class T>
+			struct pointer_resolver<std::optional<T>> {
+				static constexpr auto fn = &pointer_resolve_nullable<std::optional<T>, T>;
+			};
+
+			// the values set() converts when they aren't exactly of the referenced type
+			using pointer_sources = std::tuple<bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int,
+				long, unsigned long, long long, unsigned long long, float, double, long double, std::string_view>;
+
+			template<class T>
+			struct is_std_string : std::false_type {};
+			template<class TR, class A>
+			struct is_std_string<std::basic_string<char, TR, A>> : std::true_type {};
+			template<class T>
+			struct is_fixed_string : std::false_type {};
+			template<size_t N>
+			struct is_fixed_string<fixed_string<N>> : std::true_type {};
+
+			// arithmetic values convert like static_cast, strings go to std::string (keeping the allocator),
+			// fixed_string and char arrays if they fit
+			template<class L, class S>
+			bool pointer_assign_from(L& dst, const S& src) {
+				if constexpr (std::is_arithmetic_v<L> && std::is_arithmetic_v<S>) {
+					dst = static_cast<L>(src);
+					return true;
+				} else if constexpr (std::is_same_v<S, std::string_view> && is_std_string<L>::value) {
+					dst.assign(src.data(), src.size());
+					return true;
+				} else if constexpr (std::is_same_v<S, std::string_view> && is_fixed_string<L>::value) {
+					return dst.assign(src);
+				} else if constexpr (std::is_same_v<S, std::string_view> && std::is_array_v<L> && std::is_same_v<std::remove_extent_t<L>, char>) {
+					if (src.size() >= std::extent_v<L>)
+						return false;
+					for (size_t i = 0; i < src.size(); i++)
+						dst[i] = src[i];
+					dst[src.size()] = 0;
+					return true;
+				} else {
+					return false;
+				}
+			}
+
+			template<class L, class S>
+			struct pointer_assigner;
+			template<class L, class ... S>
+			struct pointer_assigner<L, std::tuple<S...>> {
+				static bool assign(void* dst, const void* src, const std::type_info& src_type) {
+					bool ok = false;
+					((src_type == typeid(S) && (ok = pointer_assign_from(*static_cast<L*>(dst), *static_cast<const S*>(src)), true)) || ...);
+					return ok;
+				}
+			};
+
+			template<class T>
+			const pointer_node* pointer_node_of() {
+				static const pointer_node node{ &typeid(T), pointer_resolver<T>::fn, &pointer_assigner<T, pointer_sources>::assign };
+				return &node;
+			}
+		}
+
+		template<class T>
+		class pointer {
+			std::vector<impl::pointer_step> steps;
+			const impl::pointer_node* leaf = nullptr;
+
+			void* walk(void* p) const {
+				for (auto& s : steps) {
+					if (s.deref) {
+						p = s.deref(p, s);
+						if (!p)
+							return nullptr;
+					}
+					p = static_cast<char*>(p) + s.offset;
+				}
+				return p;
+			}
+		public:
+			pointer() = default;
+			explicit pointer(std::string_view path) {
+				compile(path);
+			}
+
+			// resolves the path against T, returns false if it can't refer to anything in T
+			bool compile(std::string_view path) {
+				steps.clear();
+				leaf = nullptr;
+				if (!path.empty() && path[0] != '/')
+					return false;
+				const impl::pointer_node* node = impl::pointer_node_of<T>();
+				std::string token;
+				size_t pos = 0;
+				while (pos < path.size()) {
+					size_t end = path.find('/', pos + 1);
+					if (end == std::string_view::npos)
+						end = path.size();
+					// unescape ~1 and ~0
+					token.clear();
+					for (size_t i = pos + 1; i < end; i++) {
+						if (path[i] == '~' && i + 1 < end && (path[i + 1] == '0' || path[i + 1] == '1')) {
+							token.push_back(path[++i] == '0' ? '~' : '/');
+						} else if (path[i] == '~') {
+							return false;
+						} else {
+							token.push_back(path[i]);
+						}
+					}
+					node = node->resolve(token, steps);
+					if (!node) {
+						steps.clear();
+						return false;
+					}
+					pos = end;
+				}
+				leaf = node;
+				return true;
+			}
+
+			explicit operator bool() const {
+				return leaf != nullptr;
+			}
+
+			// type of the referenced value
+			const std::type_info& type() const {
+				return leaf ? *leaf->type : typeid(void);
+			}
+
+			value_ref eval(T& obj) const {
+				return value_ref{ leaf ? walk(&obj) : nullptr, leaf ? leaf->type : nullptr };
+			}
+
+			// typed access, null if the value is absent (vector index or map key) or of another type
+			template<class V>
+			V* get(T& obj) const {
+				if (!leaf || *leaf->type != typeid(V))
+					return nullptr;
+				return static_cast<V*>(walk(&obj));
+			}
+			template<class V>
+			const V* get(const T& obj) const {
+				return get<V>(const_cast<T&>(obj));
+			}
+
+			// values of the referenced type are assigned as is, arithmetic values and strings (std::string,
+			// std::string_view, const char*) are converted by the assigner of the referenced type. False if the value
+			// is absent or can't be converted (ie: a string to a number or a too long string to a char array).
+			template<class V>
+			bool set(T& obj, V&& v) const {
+				using D = std::decay_t<V>;
+				if (!leaf)
+					return false;
+				if (*leaf->type == typeid(D)) {
+					auto* dst = static_cast<D*>(walk(&obj));
+					if (!dst)
+						return false;
+					*dst = std::forward<V>(v);
+					return true;
+				}
+				if constexpr (std::is_arithmetic_v<D>) {
+					void* dst = walk(&obj);
+					return dst && leaf->assign(dst, &v, typeid(D));
+				} else if constexpr (std::is_convertible_v<const D&, std::string_view>) {
+					std::string_view sv = v;
+					void* dst = walk(&obj);
+					return dst && leaf->assign(dst, &sv, typeid(std::string_view));
+				} else {
+					return false;
+				}
+			}
+
+			// evaluates over a batch of objects, out receives one pointer (or null) per object
+			template<class V>
+			bool get_all(std::vector<T>& objs, std::vector<V*>& out) const {
+				out.clear();
+				if (!leaf || *leaf->type != typeid(V))
+					return false;
+				out.reserve(objs.size());
+				for (auto& o : objs)
+					out.push_back(static_cast<V*>(walk(&o)));
+				return true;
+			}
+		};
+	}
+}
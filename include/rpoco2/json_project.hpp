@@ -0,0 +1,17 @@
+#pragma once
+
+#include "json.hpp"
+#include "project.hpp"
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			template<class T, auto ... MP, class CTX>
+			struct parser<project<T, MP...>, CTX> {
+				static bool parse(project<T, MP...>& p, CTX& ctx) {
+					return parse_members(*p.type_info(), p.target, ctx);
+				}
+			};
+		}
+	}
+}
@@ -5,6 +5,8 @@
 #include "json_std_vector.hpp"
 #include "json_std_map.hpp"
 #include "json_std_shared.hpp"
+#include "json_std_unique.hpp"
+#include "json_std_optional.hpp"
 
 #include <any>
 
@@ -13,24 +15,43 @@ namespace rpoco2 {
 
 		namespace impl {
 
+			template<class C>
+			C& any_emplace(std::any& v, std::pmr::memory_resource* res) {
+				if constexpr (std::is_constructible_v<typename C::allocator_type, std::pmr::memory_resource*>)
+					return v.emplace<C>(typename C::allocator_type(res));
+				else
+					return v.emplace<C>();
+			}
+
+			// the dom is std::map<std::string, std::any>, std::vector<std::any> and std::string. With
+			// parse_options::pmr_dom it is std::pmr::map<std::pmr::string, std::any>, std::pmr::vector<std::any> and
+			// std::pmr::string on the parse resource instead, only the std::any boxes still come from the heap.
 			template<class CTX>
 			struct parser<std::any, CTX> {
 				static bool parse(std::any& v, CTX& ctx) {
+					if (ctx_pmr_dom(ctx)) {
+						std::pmr::memory_resource* res = ctx_resource(ctx);
+						return parse_as<std::pmr::map<std::pmr::string, std::any>, std::pmr::vector<std::any>, std::pmr::string>(v, ctx,
+							res ? res : std::pmr::get_default_resource());
+					}
+					return parse_as<std::map<std::string, std::any>, std::vector<std::any>, std::string>(v, ctx, nullptr);
+				}
 
+				template<class OBJ, class ARR, class STR>
+				static bool parse_as(std::any& v, CTX& ctx, std::pmr::memory_resource* res) {
 					int ty = parse_peek(ctx);
 					switch (ty) {
 					case '{': {
-						v.emplace<std::map<std::string, std::any>>();
-						//auto& ref = ;
-						return parser<std::map<std::string, std::any>, CTX>::parse(
-							std::any_cast<std::map<std::string, std::any>&>(v),
+						auto& ref = any_emplace<OBJ>(v, res);
+						return parser<OBJ, CTX>::parse(
+							ref,
 							ctx
 							);
 					}
 					case '[': {
-						v.emplace<std::vector<std::any>>();
-						return parser<std::vector<std::any>, CTX>::parse(
-							std::any_cast<std::vector<std::any>&>(v),
+						auto& ref = any_emplace<ARR>(v, res);
+						return parser<ARR, CTX>::parse(
+							ref,
 							ctx
 							);
 					}
@@ -50,9 +71,9 @@ namespace rpoco2 {
 						return rv;
 					}
 					case '\"': {
-						v.emplace<std::string>();
-						return parser<std::string, CTX>::parse(
-							std::any_cast<std::string&>(v),
+						auto& ref = any_emplace<STR>(v, res);
+						return parser<STR, CTX>::parse(
+							ref,
 							ctx
 							);
 					}
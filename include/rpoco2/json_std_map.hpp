@@ -6,14 +6,18 @@
 namespace rpoco2 {
 	namespace json {
 		namespace impl {
-			template<typename V, class CTX>
-			struct parser<std::map<std::string,V>, CTX> {
-				static bool parse(std::map<std::string,V> &v, CTX& ctx) {
-					std::string key;
+			template<typename TR, class KA, typename V, class C, class A, class CTX>
+			struct parser<std::map<std::basic_string<char, TR, KA>, V, C, A>, CTX> {
+				using key_type = std::basic_string<char, TR, KA>;
+				static bool parse(std::map<key_type, V, C, A> &v, CTX& ctx) {
+					v.clear();
+					adopt_resource(v, ctx);
+					// the key shares the map's allocator
+					key_type key(KA(v.get_allocator()));
 					auto keyFn =
 						[&key](CTX& ctx) {
 						key.clear();
-						return parser<std::string, CTX>::parse(key, ctx);
+						return parser<key_type, CTX>::parse(key, ctx);
 					};
 					auto valFn = [&key, &v](CTX& ctx) {
 						return parser<V, CTX>::parse(v[key], ctx);
@@ -25,4 +29,3 @@ namespace rpoco2 {
 		}
 	}
 }
-
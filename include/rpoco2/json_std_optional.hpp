@@ -0,0 +1,28 @@
+#pragma once
+
+#include "json.hpp"
+#include <optional>
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			// null resets, absent members are left as they are
+			template<typename T, class CTX>
+			struct parser<std::optional<T>, CTX> {
+				static bool parse(std::optional<T>& v, CTX& ctx) {
+
+					auto peek = parse_peek(ctx);
+					if (!peek)
+						return false;
+					if (peek == 'n') {
+						v.reset();
+						return parse_known(ctx,"null");
+					} else {
+						v.emplace();
+						return parser<T, CTX>::parse(*v, ctx);
+					}
+				}
+			};
+		}
+	}
+}
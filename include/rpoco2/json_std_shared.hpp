@@ -16,7 +16,10 @@ namespace rpoco2 {
 					if (peek == 'n') {
 						return parse_known(ctx,"null");
 					} else {
-						v = std::make_shared<T>();
+						if (auto* res = ctx_resource(ctx))
+							v = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(res));
+						else
+							v = std::make_shared<T>();
 						return parser<T, CTX>::parse(*v, ctx);
 					}
 				}
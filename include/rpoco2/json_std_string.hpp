@@ -7,11 +7,12 @@ namespace rpoco2 {
 	namespace json {
 		namespace impl {
 
-			template<class CTX>
-			struct parser<std::string, CTX> {
-				static bool parse(std::string &s, CTX& ctx) {
+			// std::string and std::pmr::string
+			template<class TR, class A, class CTX>
+			struct parser<std::basic_string<char, TR, A>, CTX> {
+				static bool parse(std::basic_string<char, TR, A> &s, CTX& ctx) {
 					struct {
-						std::string * ptr;
+						std::basic_string<char, TR, A> * ptr;
 						void reset() {
 							ptr->clear();
 						}
@@ -19,9 +20,15 @@ namespace rpoco2 {
 							ptr->push_back(c);
 							return true;
 						}
+						bool append(const char* p, size_t n) {
+							ptr->append(p, n);
+							return true;
+						}
 						void term() {}
 					}ssw;
 					ssw.ptr = &s;
+					ssw.reset();
+					adopt_resource(s, ctx);
 					return parse_string(ssw, ctx);
 				}
 			};
@@ -29,4 +36,3 @@ namespace rpoco2 {
 		}
 	}
 }
-
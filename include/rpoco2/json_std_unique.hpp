@@ -0,0 +1,27 @@
+#pragma once
+
+#include "json.hpp"
+#include <memory>
+
+namespace rpoco2 {
+	namespace json {
+		namespace impl {
+			template<typename T, class CTX>
+			struct parser<std::unique_ptr<T>, CTX> {
+				static bool parse(std::unique_ptr<T>& v, CTX& ctx) {
+
+					auto peek = parse_peek(ctx);
+					if (!peek)
+						return false;
+					if (peek == 'n') {
+						v.reset();
+						return parse_known(ctx,"null");
+					} else {
+						v = std::make_unique<T>();
+						return parser<T, CTX>::parse(*v, ctx);
+					}
+				}
+			};
+		}
+	}
+}
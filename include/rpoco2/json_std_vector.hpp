@@ -6,9 +6,11 @@
 namespace rpoco2 {
 	namespace json {
 		namespace impl {
-			template<typename T, class CTX>
-			struct parser<std::vector<T>, CTX> {
-				static bool parse(std::vector<T> &v, CTX& ctx) {
+			template<typename T, class A, class CTX>
+			struct parser<std::vector<T, A>, CTX> {
+				static bool parse(std::vector<T, A> &v, CTX& ctx) {
+					v.clear();
+					adopt_resource(v, ctx);
 					auto fn = [&v](CTX& ctx, int idx) {
 						v.emplace_back();
 						return parser<T,CTX>::parse(v[idx],ctx);
@@ -22,4 +24,3 @@ namespace rpoco2 {
 		}
 	}
 }
-
@@ -0,0 +1,786 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <vector>
+
+namespace rpoco2 {
+	namespace json {
+
+		enum class error {
+			none=0,
+			unexpected_end,   // input ended inside a value
+			unexpected_char,  // token not allowed at this point
+			bad_string,       // bad escape, control character or invalid utf-8 in a string
+			bad_number,
+			trailing          // more data after the document
+		};
+
+		struct validate_result {
+			error code;
+			size_t offset;    // byte offset of the error
+
+			explicit operator bool() const {
+				return code == error::none;
+			}
+		};
+
+		namespace impl {
+			// nesting kinds (object or array) of the containers we're inside, a bit per level
+			class nest_stack {
+				uint64_t inl[4];
+				std::vector<uint64_t> ext;
+				size_t depth = 0;
+				uint64_t& word(size_t d) {
+					return d < 256 ? inl[d / 64] : ext[(d - 256) / 64];
+				}
+			public:
+				void push(bool is_object) {
+					if (depth >= 256 && (depth - 256) / 64 >= ext.size())
+						ext.push_back(0);
+					uint64_t bit = uint64_t(1) << (depth % 64);
+					if (is_object)
+						word(depth) |= bit;
+					else
+						word(depth) &= ~bit;
+					depth++;
+				}
+				void pop() {
+					depth--;
+				}
+				bool top_is_object() {
+					return (word(depth - 1) >> ((depth - 1) % 64)) & 1;
+				}
+				size_t size() const {
+					return depth;
+				}
+			};
+
+			inline int hex_value(char c) {
+				if ('0' <= c && c <= '9')
+					return c - '0';
+				if ('a' <= c && c <= 'f')
+					return c - 'a' + 10;
+				if ('A' <= c && c <= 'F')
+					return c - 'A' + 10;
+				return -1;
+			}
+
+			// validates a \uXXXX escape at p (pointing past the \u), returns the codepoint or -1
+			inline long scan_hex4(const char*& p, const char* e) {
+				if (e - p < 4)
+					return -1;
+				long cp = 0;
+				for (int i = 0; i < 4; i++) {
+					int h = hex_value(p[i]);
+					if (h < 0)
+						return -1;
+					cp = cp * 16 + h;
+				}
+				p += 4;
+				return cp;
+			}
+
+			// validates the string at p (pointing at the opening quote) and moves p past it
+			inline error scan_string_token(const char*& p, const char* e, utf8_mode mode) {
+				p++;
+				while (true) {
+					size_t n = scan_string(p, e);
+					if (mode == utf8_mode::reject) {
+						size_t bad;
+						size_t ok = utf8_validate(p, n, bad);
+						if (ok < n) {
+							p += ok;
+							return error::bad_string;
+						}
+					}
+					p += n;
+					if (p == e)
+						return error::unexpected_end;
+					char c = *p;
+					if (c == '\"') {
+						p++;
+						return error::none;
+					} else if (c != '\\') {
+						// raw control characters aren't allowed in strings
+						return error::bad_string;
+					}
+					if (++p == e)
+						return error::unexpected_end;
+					switch (*p++) {
+					case '\"': case '\\': case '/':
+					case 'b': case 'f': case 'n': case 'r': case 't':
+						continue;
+					case 'u': {
+						long cp = scan_hex4(p, e);
+						if (cp < 0)
+							return error::bad_string;
+						if (mode != utf8_mode::reject)
+							continue;
+						// strict mode requires surrogates to be paired
+						if (0xDC00 <= cp && cp <= 0xDFFF)
+							return error::bad_string;
+						if (0xD800 <= cp && cp <= 0xDBFF) {
+							if (e - p < 2 || p[0] != '\\' || p[1] != 'u')
+								return error::bad_string;
+							p += 2;
+							long lo = scan_hex4(p, e);
+							if (lo < 0xDC00 || 0xDFFF < lo)
+								return error::bad_string;
+						}
+						continue;
+					}
+					default:
+						return error::bad_string;
+					}
+				}
+			}
+
+			// 8 bytes at a time (little endian), digits are the bytes that keep 3 in the high nibble after adding 6,
+			// the lowest non-zero byte of the result is the first non-digit
+			inline uint64_t nondigit_bytes(uint64_t v) {
+				return ((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ^ 0x3333333333333333ull;
+			}
+
+			inline const char* scan_digits(const char* p, const char* e) {
+#if RPOCO2_SSE2
+				while (e - p >= 8) {
+					uint64_t v;
+					memcpy(&v, p, 8);
+					uint64_t x = nondigit_bytes(v);
+					if (x)
+						return p + ctz64(x) / 8;
+					p += 8;
+				}
+#endif
+				while (p < e && '0' <= *p && *p <= '9')
+					p++;
+				return p;
+			}
+
+			// validates the number at p against the json grammar and moves p past it
+			inline error scan_number_token(const char*& p, const char* e) {
+				if (*p == '-')
+					p++;
+				if (p == e)
+					return error::unexpected_end;
+				if (*p == '0') {
+					p++;
+				} else if ('1' <= *p && *p <= '9') {
+					p = scan_digits(p + 1, e);
+				} else return error::bad_number;
+				if (p < e && *p == '.') {
+					const char* d = ++p;
+					p = scan_digits(p, e);
+					if (p == d)
+						return p == e ? error::unexpected_end : error::bad_number;
+				}
+				if (p < e && (*p == 'e' || *p == 'E')) {
+					p++;
+					if (p < e && (*p == '+' || *p == '-'))
+						p++;
+					const char* d = p;
+					p = scan_digits(p, e);
+					if (p == d)
+						return p == e ? error::unexpected_end : error::bad_number;
+				}
+				return error::none;
+			}
+
+			// true, false and null, compared as a single word when enough input remains
+			inline error scan_literal(const char*& p, const char* e, const char* lit, size_t len) {
+				if ((size_t)(e - p) >= 8) {
+					uint64_t v, l = 0;
+					memcpy(&v, p, 8);
+					memcpy(&l, lit, len);
+					uint64_t mask = ~uint64_t(0) >> (64 - len * 8);
+					if ((v & mask) != l)
+						return error::unexpected_char;
+					p += len;
+					return error::none;
+				}
+				size_t avail = (size_t)(e - p) < len ? (size_t)(e - p) : len;
+				if (memcmp(p, lit, avail))
+					return error::unexpected_char;
+				if (avail < len)
+					return error::unexpected_end;
+				p += len;
+				return error::none;
+			}
+
+			// non-recursive scan of a whole document, runs of non-whitespace bytes are handed to the sink
+			// (that is all minification needs since whitespace inside strings is part of the string token)
+			template<class SINK>
+			validate_result scan_document(const char* src, size_t len, utf8_mode mode, SINK& sink) {
+				enum {
+					VALUE,          // expecting a value
+					VALUE_OR_END,   // after [
+					KEY,            // expecting a key, after a comma in an object
+					KEY_OR_END,     // after {
+					COLON,
+					AFTER           // after a value
+				} state = VALUE;
+				nest_stack stack;
+				const char* p = src;
+				const char* e = src + len;
+				const char* run = p;
+				auto fail = [&](error code) {
+					return validate_result{ code, size_t(p - src) };
+				};
+				while (true) {
+					if (p < e && is_space(*p)) {
+						sink(run, p - run);
+						p += scan_space(p, e);
+						run = p;
+					}
+					if (p == e) {
+						sink(run, p - run);
+						if (state == AFTER && stack.size() == 0)
+							return validate_result{ error::none, len };
+						return fail(error::unexpected_end);
+					}
+					char c = *p;
+					error err = error::none;
+					switch (state) {
+					case VALUE_OR_END:
+						if (c == ']') {
+							p++;
+							stack.pop();
+							state = AFTER;
+							continue;
+						}
+						// fallthrough
+					case VALUE:
+						switch (c) {
+						case '{':
+							p++;
+							stack.push(true);
+							state = KEY_OR_END;
+							continue;
+						case '[':
+							p++;
+							stack.push(false);
+							state = VALUE_OR_END;
+							continue;
+						case '\"':
+							err = scan_string_token(p, e, mode);
+							break;
+						case 't':
+							err = scan_literal(p, e, "true", 4);
+							break;
+						case 'f':
+							err = scan_literal(p, e, "false", 5);
+							break;
+						case 'n':
+							err = scan_literal(p, e, "null", 4);
+							break;
+						default:
+							if (c == '-' || ('0' <= c && c <= '9'))
+								err = scan_number_token(p, e);
+							else
+								err = error::unexpected_char;
+						}
+						if (err != error::none)
+							return fail(err);
+						state = AFTER;
+						continue;
+					case KEY_OR_END:
+						if (c == '}') {
+							p++;
+							stack.pop();
+							state = AFTER;
+							continue;
+						}
+						// fallthrough
+					case KEY:
+						if (c != '\"')
+							return fail(error::unexpected_char);
+						err = scan_string_token(p, e, mode);
+						if (err != error::none)
+							return fail(err);
+						state = COLON;
+						continue;
+					case COLON:
+						if (c != ':')
+							return fail(error::unexpected_char);
+						p++;
+						state = VALUE;
+						continue;
+					case AFTER:
+						if (stack.size() == 0)
+							return fail(error::trailing);
+						if (c == ',') {
+							p++;
+							state = stack.top_is_object() ? KEY : VALUE;
+							continue;
+						} else if (c == (stack.top_is_object() ? '}' : ']')) {
+							p++;
+							stack.pop();
+							continue;
+						}
+						return fail(error::unexpected_char);
+					}
+				}
+			}
+
+#if RPOCO2_SSE2
+			// whitespace or an operator, the bytes a number or literal may end on (as bitmaps of the bytes 0-63 and 64-127)
+			constexpr bool is_delimiter(char c) {
+				const uint64_t lo = (1ull << ' ') | (1ull << '\t') | (1ull << '\n') | (1ull << '\r') | (1ull << ',') | (1ull << ':');
+				const uint64_t hi = (1ull << ('[' - 64)) | (1ull << (']' - 64)) | (1ull << ('{' - 64)) | (1ull << ('}' - 64));
+				unsigned char u = c;
+				return u < 128 && (((u < 64 ? lo : hi) >> (u & 63)) & 1);
+			}
+
+			// bit i is the xor of bits 0..i, turns the opening and closing quotes into string interiors
+			inline uint64_t prefix_xor(uint64_t m) {
+				m ^= m << 1;
+				m ^= m << 2;
+				m ^= m << 4;
+				m ^= m << 8;
+				m ^= m << 16;
+				m ^= m << 32;
+				return m;
+			}
+
+			// the 64 bit mask of the bytes of v[0..3] selected by fn (a 16 byte compare)
+			template<class F>
+			inline uint64_t block_mask(const __m128i* v, F&& fn) {
+				uint64_t m = 0;
+				for (int k = 0; k < 4; k++)
+					m |= uint64_t((unsigned)_mm_movemask_epi8(fn(v[k]))) << (16 * k);
+				return m;
+			}
+
+			// classifies 64 bytes at a time into bitmasks (bit i is byte i) with escapes and strings tracked across blocks,
+			// everything inside strings except escapes is checked here so only the tokens need a second look
+			class structural_scanner {
+				uint64_t escaped_carry = 0;   // 1 if the first byte of the next block is escaped
+				uint64_t string_carry = 0;    // all ones if the last block ended inside a string
+				uint64_t scalar_carry = 0;    // 1 if the last block ended inside a number or literal
+				uint64_t cont_carry = 0;      // continuation bytes the sequences of the last block still need
+				uint64_t lead_carry = 0;      // the last block ended on E0, ED, F0 or F4 (bits 0-3)
+				uint64_t error = 0;           // raw control characters in strings, backslashes outside of them, bad utf-8
+				bool check_utf8;
+
+				// utf-8 as bitmasks, every lead byte requires the continuation bytes after it and every continuation
+				// byte needs a lead, the leads that restrict the range of the second byte are checked one by one
+				void check_sequences(const __m128i* v) {
+					auto ge = [v](int c) {
+						// unsigned compares as signed ones on the flipped top bit
+						const __m128i lim = _mm_set1_epi8((char)((c - 1) ^ 0x80));
+						return block_mask(v, [lim](__m128i x) {
+							return _mm_cmpgt_epi8(_mm_xor_si128(x, _mm_set1_epi8((char)0x80)), lim);
+						});
+					};
+					auto eq = [v](int c) {
+						return block_mask(v, [c](__m128i x) {
+							return _mm_cmpeq_epi8(x, _mm_set1_epi8((char)c));
+						});
+					};
+					uint64_t hi = block_mask(v, [](__m128i x) {
+						return x;
+					});
+					if (!hi) {
+						// ascii, only sequences left open by the last block can be wrong
+						error |= cont_carry;
+						cont_carry = lead_carry = 0;
+						return;
+					}
+					uint64_t lead2 = ge(0xC0), lead3 = ge(0xE0), lead4 = ge(0xF0);
+					uint64_t cont = hi & ~lead2;
+					uint64_t required = (lead2 << 1) | (lead3 << 2) | (lead4 << 3) | cont_carry;
+					cont_carry = (lead2 >> 63) | (lead3 >> 62) | (lead4 >> 61);
+					error |= (required ^ cont) | (lead2 & ~ge(0xC2)) | ge(0xF5);
+
+					// overlong E0 and F0 sequences, surrogates after ED and codepoints past U+10FFFF after F4
+					uint64_t e0 = eq(0xE0), ed = eq(0xED), f0 = eq(0xF0), f4 = eq(0xF4);
+					if (e0 | ed | f0 | f4 | lead_carry) {
+						uint64_t a0 = ge(0xA0), n90 = ge(0x90);
+						error |= (((e0 << 1) | (lead_carry & 1)) & ~a0) | (((ed << 1) | ((lead_carry >> 1) & 1)) & a0)
+							| (((f0 << 1) | ((lead_carry >> 2) & 1)) & ~n90) | (((f4 << 1) | ((lead_carry >> 3) & 1)) & n90);
+					}
+					lead_carry = (e0 >> 63) | ((ed >> 63) << 1) | ((f0 >> 63) << 2) | ((f4 >> 63) << 3);
+				}
+			public:
+				uint64_t structurals;         // brackets, colons, commas and the first byte of every other token
+				uint64_t escaped;             // bytes following an escaping backslash
+				uint64_t space;               // whitespace outside of strings
+				uint64_t unchecked;           // operators and the bytes of numbers and literals that aren't part of a plain integer
+
+				explicit structural_scanner(bool check_utf8) : check_utf8(check_utf8) {}
+
+				void block(const char* p) {
+					__m128i v[4];
+					for (int k = 0; k < 4; k++)
+						v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+					uint64_t q = block_mask(v, [](__m128i x) {
+						return _mm_cmpeq_epi8(x, _mm_set1_epi8('\"'));
+					});
+					uint64_t bs = block_mask(v, [](__m128i x) {
+						return _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'));
+					});
+					uint64_t ws = block_mask(v, [](__m128i x) {
+						return _mm_or_si128(
+							_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))),
+							_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))));
+					});
+					uint64_t op = block_mask(v, [](__m128i x) {
+						// setting bit 5 folds [ and ] onto { and }
+						__m128i lc = _mm_or_si128(x, _mm_set1_epi8(0x20));
+						return _mm_or_si128(
+							_mm_or_si128(_mm_cmpeq_epi8(lc, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lc, _mm_set1_epi8('}'))),
+							_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(',')), _mm_cmpeq_epi8(x, _mm_set1_epi8(':'))));
+					});
+					uint64_t ctl = block_mask(v, [](__m128i x) {
+						return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1F)), x);
+					});
+					if (check_utf8)
+						check_sequences(v);
+
+					// a backslash escapes the next byte unless it's escaped itself, odd bits pair up each run from its start
+					const uint64_t odd = 0xAAAAAAAAAAAAAAAAull;
+					uint64_t starts = bs & ~escaped_carry;
+					uint64_t codes = (((starts << 1) | odd) - starts) ^ odd;
+					escaped = codes ^ (bs | escaped_carry);
+					escaped_carry = (codes & bs) >> 63;
+
+					// strings run from an opening quote up to (not including) the closing one
+					uint64_t uq = q & ~escaped;
+					uint64_t in_string = prefix_xor(uq) ^ string_carry;
+					string_carry = uint64_t(int64_t(in_string) >> 63);
+					error |= (ctl & in_string) | (bs & ~in_string);
+
+					// numbers and literals start where a byte that is neither an operator nor whitespace follows one that is, strings
+					// at every unescaped opening quote
+					uint64_t scalar = ~(op | ws);
+					uint64_t follows = ((scalar & ~q) << 1) | scalar_carry;
+					scalar_carry = (scalar & ~q) >> 63;
+					structurals = (op | uq | (scalar & ~follows)) & ~(in_string ^ uq);
+					space = ws & ~in_string;
+
+					// plain integers are digits without a leading zero, tokens running into the next block and operators in
+					// value position are left to the walk
+					unchecked = op;
+					if (uint64_t tokens = scalar & ~(in_string | uq)) {
+						uint64_t digit = block_mask(v, [](__m128i x) {
+							return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), x));
+						});
+						uint64_t zero = block_mask(v, [](__m128i x) {
+							return _mm_cmpeq_epi8(x, _mm_set1_epi8('0'));
+						});
+						unchecked |= tokens & (~digit | ((zero & structurals) << 1) | (uint64_t(1) << 63));
+					}
+				}
+
+				bool in_string() const {
+					return string_carry != 0;
+				}
+
+				bool failed() const {
+					return error != 0;
+				}
+
+				// a sequence cut short by the end of the input
+				void finish() {
+					error |= cont_carry;
+				}
+			};
+
+			// copies the bytes of the n (at most 64) at p whose bit in space is clear to out and returns their count,
+			// runs are copied 16 bytes at a time when wide is set (p and out need 15 bytes of room past the block)
+			inline size_t compact_bits(char* out, const char* p, size_t n, uint64_t space, bool wide) {
+				uint64_t keep = ~space & (n < 64 ? (uint64_t(1) << n) - 1 : ~uint64_t(0));
+				size_t o = 0;
+				while (keep) {
+					int s = ctz64(keep);
+					uint64_t rest = ~(keep >> s);
+					int l = rest ? ctz64(rest) : 64 - s;
+					if (wide) {
+						for (int k = 0; k < l; k += 16)
+							memcpy(out + o + k, p + s + k, 16);
+					} else {
+						memcpy(out + o, p + s, l);
+					}
+					o += l;
+					keep = s + l < 64 ? keep & (~uint64_t(0) << (s + l)) : 0;
+				}
+				return o;
+			}
+
+			// a number or literal at t that has to end where the next token (or whitespace) begins,
+			// literals and short integers are checked straight from the input, anything else by the token scans
+			inline bool scan_scalar(const char* t, const char* e) {
+				if (e - t >= 16) {
+					switch (*t) {
+					case 't':
+						return !memcmp(t, "true", 4) && is_delimiter(t[4]);
+					case 'f':
+						return !memcmp(t, "false", 5) && is_delimiter(t[5]);
+					case 'n':
+						return !memcmp(t, "null", 4) && is_delimiter(t[4]);
+					default: {
+						const char* d = t + (*t == '-');
+						uint64_t v;
+						memcpy(&v, d, 8);
+						uint64_t x = nondigit_bytes(v);
+						int n = x ? ctz64(x) / 8 : 8;
+						if (n > 0 && n < 8 && (n == 1 || *d != '0') && is_delimiter(d[n]))
+							return true;
+					}
+					}
+				}
+				error err;
+				switch (*t) {
+				case 't':
+					err = scan_literal(t, e, "true", 4);
+					break;
+				case 'f':
+					err = scan_literal(t, e, "false", 5);
+					break;
+				case 'n':
+					err = scan_literal(t, e, "null", 4);
+					break;
+				default:
+					if (*t != '-' && (*t < '0' || '9' < *t))
+						return false;
+					err = scan_number_token(t, e);
+				}
+				return err == error::none && (t == e || is_delimiter(*t));
+			}
+
+			// the fast path of scan_document, returns false instead of locating errors (scan_document does that on the rare invalid input),
+			// runs before run were handed to the sink and are known to be the same as scan_document would produce.
+			// The walk takes the token starts straight from the bits of one block at a time and every state is a label of its own
+			// (instead of a switch over a state variable) so the branches of each are predicted apart.
+			template<bool EMIT, class SINK>
+			bool scan_structural(const char* src, size_t len, utf8_mode mode, SINK& sink, const char*& run) {
+				const char* e = src + len;
+				// output goes out a chunk at a time once the walk has moved past it, so that on errors the sink has
+				// seen no more than scan_document would have handed it
+				constexpr size_t CHUNK = 4096;
+				uint64_t spaces[CHUNK / 64];
+				char packed[EMIT ? CHUNK + 16 : 1];
+				alignas(16) char tail[64];
+				structural_scanner scan(mode == utf8_mode::reject);
+				const char* low_surrogate = nullptr;   // the second half of a checked pair
+				const char* chunk = src;
+				const char* block = src;               // the next block to scan
+				const char* found = src;               // the block refill found tokens in
+				uint64_t found_unchecked = 0;
+				bool string_error = false;
+
+				// writes the non-whitespace of the chunk up to its last whitespace, the rest is the start of the pending run
+				auto emit = [&]() -> bool {
+					if (scan.failed())
+						return false;
+					size_t clen = block - chunk, last = clen;
+					while (last && !spaces[(last - 1) / 64])
+						last = (last - 1) / 64 * 64;
+					if (last) {
+						last -= clz64(spaces[(last - 1) / 64] << (63 - (last - 1) % 64));
+						// the pending run has no whitespace
+						sink(run, chunk - run);
+						size_t n = 0;
+						for (size_t b = 0; b < last; b += 64)
+							n += compact_bits(packed + n, chunk + b, last - b < 64 ? last - b : 64, spaces[b / 64], e - (chunk + b) >= 80);
+						sink(packed, n);
+						run = chunk + last;
+					}
+					chunk = block;
+					return true;
+				};
+
+				// scans up to the next block with tokens and returns their bits, 0 at the end of input or on errors inside strings
+				auto refill = [&]() -> uint64_t {
+					while (true) {
+						if constexpr (EMIT) {
+							if (block == chunk + CHUNK && !emit()) {
+								string_error = true;
+								return 0;
+							}
+						}
+						if (block == e)
+							return 0;
+						const char* p = block;
+						if (e - block < 64) {
+							// whitespace padding ends the last token like the end of input
+							memset(tail, ' ', 64);
+							memcpy(tail, block, e - block);
+							p = tail;
+						}
+						scan.block(p);
+						if constexpr (EMIT) {
+							// the padding isn't whitespace of the input
+							spaces[(block - chunk) / 64] = p == tail ? scan.space & ((uint64_t(1) << (e - block)) - 1) : scan.space;
+						}
+
+						// escapes are rare enough to check one by one
+						for (uint64_t m = scan.escaped; m; m &= m - 1) {
+							int k = ctz64(m);
+							switch (p[k]) {
+							case '\"': case '\\': case '/':
+							case 'b': case 'f': case 'n': case 'r': case 't':
+								continue;
+							case 'u': {
+								const char* h = block + k + 1;
+								long cp = scan_hex4(h, e);
+								if (cp >= 0 && mode == utf8_mode::reject) {
+									if (0xDC00 <= cp && cp <= 0xDFFF) {
+										if (block + k != low_surrogate)
+											cp = -1;
+									} else if (0xD800 <= cp && cp <= 0xDBFF) {
+										if (e - h < 2 || h[0] != '\\' || h[1] != 'u') {
+											cp = -1;
+										} else {
+											low_surrogate = h + 1;
+											h += 2;
+											long lo = scan_hex4(h, e);
+											if (lo < 0xDC00 || 0xDFFF < lo)
+												cp = -1;
+										}
+									}
+								}
+								if (cp >= 0)
+									continue;
+							}
+							// fallthrough
+							default:
+								string_error = true;
+								return 0;
+							}
+						}
+						found = block;
+						found_unchecked = scan.unchecked;
+						block = e - block < 64 ? e : block + 64;
+						if (scan.structurals)
+							return scan.structurals;
+					}
+				};
+
+				// the walk keeps its position in locals, only refills touch the block state
+				uint64_t bits = 0, unchecked = 0;
+				const char* base = src;
+				auto next = [&]() -> const char* {
+					if (!bits) {
+						if (!(bits = refill()))
+							return nullptr;
+						base = found;
+						unchecked = found_unchecked;
+					}
+					const char* t = base + ctz64(bits);
+					bits &= bits - 1;
+					return t;
+				};
+
+				nest_stack stack;
+				const char* t;
+			value:
+				if (!(t = next()))
+					return false;
+			value_token:
+				switch (*t) {
+				case '{':
+					stack.push(true);
+					if (!(t = next()))
+						return false;
+					if (*t == '}') {
+						stack.pop();
+						goto after_value;
+					}
+					goto key_token;
+				case '[':
+					stack.push(false);
+					if (!(t = next()))
+						return false;
+					if (*t == ']') {
+						stack.pop();
+						goto after_value;
+					}
+					goto value_token;
+				case '\"':
+					goto after_value;
+				default:
+					// the token runs up to the next one, plain integers passed with the block scan
+					if ((unchecked & ((bits & (0 - bits)) - (uint64_t(1) << (t - base)))) && !scan_scalar(t, e))
+						return false;
+					goto after_value;
+				}
+			key_token:
+				if (*t != '\"' || !(t = next()) || *t != ':')
+					return false;
+				goto value;
+			after_value:
+				if (stack.size() == 0)
+					goto document_end;
+				if (!(t = next()))
+					return false;
+				if (stack.top_is_object()) {
+					if (*t == ',') {
+						if (!(t = next()))
+							return false;
+						goto key_token;
+					}
+					if (*t != '}')
+						return false;
+				} else {
+					if (*t == ',')
+						goto value;
+					if (*t != ']')
+						return false;
+				}
+				stack.pop();
+				goto after_value;
+			document_end:
+				// runs the block scans to the end of input, a token after the document is trailing data
+				if (bits || refill() || string_error)
+					return false;
+				scan.finish();
+				if (scan.failed() || scan.in_string())
+					return false;
+				if constexpr (EMIT) {
+					if (block != chunk)
+						emit();
+					sink(run, e - run);
+				}
+				return true;
+			}
+#endif
+
+			// scan_structural where possible, scan_document for the exact error
+			template<bool EMIT, class SINK>
+			validate_result validate_document(const char* src, size_t len, utf8_mode mode, SINK& sink) {
+#if RPOCO2_SSE2
+				const char* run = src;
+				if (scan_structural<EMIT>(src, len, mode, sink, run))
+					return validate_result{ error::none, len };
+				// the runs before run are already out
+				auto rest = [&sink, run](const char* p, size_t n) {
+					if (p >= run)
+						sink(p, n);
+				};
+				return scan_document(src, len, mode, rest);
+#else
+				return scan_document(src, len, mode, sink);
+#endif
+			}
+		}
+
+		// checks that src is a single well formed json document
+		inline validate_result validate(const char* src, size_t len, const parse_options& options = parse_options{}) {
+			auto sink = [](const char*, size_t) {};
+			return impl::validate_document<false>(src, len, options.utf8, sink);
+		}
+
+		// appends src without insignificant whitespace to out (anything with append(const char*, size_t), ie std::string),
+		// on errors out holds the output up to the point of the error
+		template<class OUT>
+		validate_result minify(const char* src, size_t len, OUT& out, const parse_options& options = parse_options{}) {
+			auto sink = [&out](const char* p, size_t n) {
+				if (n)
+					out.append(p, n);
+			};
+			return impl::validate_document<true>(src, len, options.utf8, sink);
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "rpoco.hpp"
+
+namespace rpoco2 {
+
+	namespace impl2 {
+		// builds a type-info over the listed members of T, names and options are taken from T's declaration
+		template<class T, auto ... MP>
+		constexpr auto project_ti() {
+			static_assert(((member_index<T, MP>() >= 0) && ...), "projected member is not declared in the RPOCO2 list");
+			constexpr int idx[] = { member_index<T, MP>()... };
+			std::array<nameidx, sizeof...(MP)> names;
+			for (std::size_t i = 0; i < sizeof...(MP); i++) {
+				names[i].name = tinfo<T>.member_names()[idx[i]].name;
+				names[i].idx = (int)i;
+			}
+			return produce(
+				names,
+				sort(names),
+				std::make_tuple(tinfo<T>.template member<member_index<T, MP>()>()...));
+		}
+
+		// the descriptors of the projected members in projection order, copied from T's table
+		template<class T, auto ... MP>
+		const member_desc& project_desc_at(int idx) {
+			static const std::array<member_desc, sizeof...(MP)> descs = { member_desc_at<T>(member_index<T, MP>())... };
+			return descs[idx];
+		}
+	}
+
+	// a view of an RPOCO2 object restricted to a subset of its members,
+	// ie: rpoco2::project<T, &T::a, &T::b> p{ obj };
+	// parsing through a projection skips all other members and foreach only visits the projected ones
+	template<class T, auto ... MP>
+	struct project {
+		T& target;
+
+		static auto type_info() {
+			static constexpr auto ti = impl2::project_ti<T, MP...>().with_descs(&impl2::project_desc_at<T, MP...>);
+			return &ti;
+		}
+
+		template<class F>
+		void foreach(const F& fn) const {
+			type_info()->foreach(&target, fn);
+		}
+	};
+}
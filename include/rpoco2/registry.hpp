@@ -0,0 +1,50 @@
+#pragma once
+
+#include "rpoco.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// global registry of RPOCO2 types by name for code that only knows types at runtime,
+// ie: RPOCO2_REGISTER(game::Player); ... auto ti = rpoco2::type_registry::global().find("game::Player");
+
+#define RPOCO2_REGISTER_CAT2(a, b) a##b
+#define RPOCO2_REGISTER_CAT(a, b) RPOCO2_REGISTER_CAT2(a, b)
+#define RPOCO2_REGISTER(T) \
+	static const bool RPOCO2_REGISTER_CAT(rpoco2_registered_, __COUNTER__) = rpoco2::type_registry::global().add(#T, T::rpoco2_type_info_get())
+
+namespace rpoco2 {
+
+	class type_registry {
+		std::mutex lock;
+		std::map<std::string, const type_info*, std::less<>> types;
+	public:
+		// registering the same name again keeps the first entry
+		bool add(std::string_view name, const type_info* ti) {
+			std::lock_guard<std::mutex> g(lock);
+			types.emplace(std::string(name), ti);
+			return true;
+		}
+
+		// the registered type-info or null
+		const type_info* find(std::string_view name) {
+			std::lock_guard<std::mutex> g(lock);
+			auto it = types.find(name);
+			return it != types.end() ? it->second : nullptr;
+		}
+
+		template<class F>
+		void foreach(const F& fn) {
+			std::lock_guard<std::mutex> g(lock);
+			for (auto& kv : types)
+				fn(std::string_view(kv.first), kv.second);
+		}
+
+		static type_registry& global() {
+			static type_registry registry;
+			return registry;
+		}
+	};
+}
@@ -4,21 +4,26 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include <array>
 #include <string_view>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
+#include <typeinfo>
 
-#define RPOCO2(...)  auto rpoco2_type_info_get() {\
+#define RPOCO2(...)  static constexpr auto rpoco2_type_info_make() {\
 	using rpoco2::impl2::opt; \
-	using T=decltype(*this); \
-	static constexpr auto names = rpoco2::impl2::parse<rpoco2::impl2::parse<-1>("" #__VA_ARGS__)>("" #__VA_ARGS__); \
-	static constexpr auto snames = rpoco2::impl2::sort(names); \
-	static constexpr auto ti = rpoco2::impl2::produce(\
+	constexpr auto names = rpoco2::impl2::parse<rpoco2::impl2::parse<-1>("" #__VA_ARGS__)>("" #__VA_ARGS__); \
+	constexpr auto snames = rpoco2::impl2::sort(names); \
+	return rpoco2::impl2::produce(\
 		names, \
 		snames, \
 		rpoco2::impl2::optize(std::tuple{}, __VA_ARGS__)); \
-	return &ti; \
+} \
+static auto rpoco2_type_info_get() {\
+	return &rpoco2::impl2::tinfo<typename decltype(rpoco2_type_info_make())::base_type>; \
 }
 
 namespace rpoco2 {
@@ -31,15 +36,83 @@ namespace rpoco2 {
 		} ignore=ignore::dummy;
 	};
 
+	// coarse classification of member types for dynamic consumers, size gives the width
+	enum class member_kind : unsigned char {
+		other=0,       // anything else, see the type id
+		boolean,
+		signed_int,
+		unsigned_int,
+		floating,
+		chars,         // zero terminated char[size]
+		object         // RPOCO2 type, see nested
+	};
+
+	struct type_info;
+
+	// runtime description of a member, a constant table per type
+	struct member_desc {
+		static constexpr std::size_t npos = std::size_t(-1);
+
+		std::string_view name;
+		void* (*access)(void* obj);              // the member of obj, applies the member pointer
+		std::size_t offset;                      // byte offset of the member in standard layout types, npos otherwise
+		std::size_t size;                        // sizeof the member
+		member_kind kind;
+		bool trivial;                            // trivially copyable, ie can be copied with memcpy
+		const std::type_info* type;              // exact type of the member
+		const type_info* nested;                 // type-info of RPOCO2 members or null
+		const std::type_info* const* options;    // types of the member options, null terminated
+
+		// the member of obj, a plain offset when known
+		void* member_of(void* obj) const {
+			return offset != npos ? static_cast<char*>(obj) + offset : access(obj);
+		}
+
+		bool has_option(const std::type_info& t) const {
+			for (auto o = options; *o; o++)
+				if (**o == t)
+					return true;
+			return false;
+		}
+	};
+
 	struct type_info {
 		virtual size_t member_count() const=0;
 		virtual const std::string_view& member_name(int idx) const=0;
+		virtual const member_desc& member_at(int idx) const=0;
+		// declaration index of the named member or -1
+		virtual int find_member(std::string_view name) const=0;
+		virtual const std::type_info& type() const=0;
+		virtual size_t type_size() const=0;
+
+		void* member_ptr(void* obj, int idx) const {
+			return member_at(idx).member_of(obj);
+		}
+		const void* member_ptr(const void* obj, int idx) const {
+			return member_at(idx).member_of(const_cast<void*>(obj));
+		}
+		// typed access to a member, null if the member isn't of type M
+		template<class M>
+		M* get_ptr(void* obj, int idx) const {
+			auto& d = member_at(idx);
+			return *d.type == typeid(M) ? static_cast<M*>(d.member_of(obj)) : nullptr;
+		}
+		template<class M>
+		const M* get_ptr(const void* obj, int idx) const {
+			return get_ptr<M>(const_cast<void*>(obj), idx);
+		}
 	};
 
 	namespace impl2 {
 		
+		// a member pointer with its options, ie: opt{ &T::member, flag{} }, a class rather than an alias of
+		// std::tuple so the braces deduce its arguments in C++17
+		template<typename ...T>
+		struct opt : std::tuple<T...> {
+			using std::tuple<T...>::tuple;
+		};
 		template<typename ...T>
-		using opt = std::tuple<T...>;
+		opt(T...) -> opt<T...>;
 
 		template<std::size_t OFFSET,typename... T,std::size_t... I>
 		constexpr auto remove_tuple_head_detail(const std::tuple<T...>& t, std::index_sequence<I...>) {
@@ -77,13 +150,70 @@ namespace rpoco2 {
 			not_found
 		};
 
-		class member_locator {
+		// keep track of name and original index (to lookup the actual sym)
+		struct nameidx {
+			std::string_view name;
+			int idx;
+
+			constexpr nameidx():name(),idx() {}
+		};
+
+		// incremental name matching over a sorted name table, narrows the range of candidates one character at a time
+		class name_matcher {
+			const nameidx* snames;
+			int count;
+			std::size_t idx;
+			int low, high;
 		public:
-			virtual member_location_result feed(char c)=0;
-			virtual bool operator()() = 0;
-			virtual bool operator()(const char* n, size_t len = -1) = 0;
+			constexpr void feed(char c) {
+				while (low <= high) {
+					auto& ln = snames[low].name;
+					auto& hn = snames[high].name;
+					if (idx >= ln.size() || ln[idx] < c) {
+						low++;
+						continue;
+					} else if (idx >= hn.size() || hn[idx] > c) {
+						high--;
+						continue;
+					} else break;
+				}
+				idx++;
+			}
+			constexpr member_location_result result() const {
+				if (low > high) {
+					return member_location_result::not_found;
+				} else if (snames[low].name.size() == idx) {
+					return member_location_result::found;
+				} else return member_location_result::not_done;
+			}
+			// declaration index of the matched member or -1
+			constexpr int index() const {
+				return result() == member_location_result::found ? snames[low].idx : -1;
+			}
+			constexpr void reset() {
+				idx = 0;
+				low = 0;
+				high = count - 1;
+			}
+			constexpr name_matcher(const nameidx* isnames, int icount) : snames(isnames), count(icount), idx(0), low(0), high(icount - 1) {}
 		};
 
+		// declaration index of the named member or -1, binary search over a sorted name table
+		constexpr int find_name(const nameidx* snames, int count, std::string_view sv) {
+			int low = 0, high = count - 1;
+			while (low <= high) {
+				int mid = (low + high) / 2;
+				int cmp = snames[mid].name.compare(sv);
+				if (cmp == 0)
+					return snames[mid].idx;
+				else if (cmp < 0)
+					low = mid + 1;
+				else
+					high = mid - 1;
+			}
+			return -1;
+		}
+
 		template<class BASE, class NAMES, class TNAME>
 		class t_ti;
 
@@ -96,6 +226,7 @@ namespace rpoco2 {
 			NAMES names;
 			NAMES snames;
 			TNAME members;
+			const member_desc& (*desc_at)(int idx);   // the descriptor table built for this member list
 
 			template<class F, std::size_t ... I>
 			inline void foreach_impl(BASE* bp, const F& fn, std::index_sequence<I...> idxs) const {
@@ -111,6 +242,7 @@ namespace rpoco2 {
 				ptrs[idx](this,bp,fn);
 			}
 		public:
+			using base_type = BASE;
 
 			virtual size_t member_count() const {
 				return names.size();
@@ -118,67 +250,27 @@ namespace rpoco2 {
 			virtual const std::string_view& member_name(int idx) const {
 				return names[idx].name;
 			}
+			virtual const member_desc& member_at(int idx) const {
+				return desc_at(idx);
+			}
+			virtual int find_member(std::string_view name) const {
+				return find_name(snames.data(), sizeof...(R), name);
+			}
+			virtual const std::type_info& type() const {
+				return typeid(BASE);
+			}
+			virtual size_t type_size() const {
+				return sizeof(BASE);
+			}
 
-			template<class F>
-			auto locator(BASE *bp,const F& fn) const {
-				class loc_impl : public member_locator {
-					const t_ti* pti;
-					const F& fn;
-					BASE* bp;
-					int idx;
-					int low, high;
-					inline void feedone(char c) {
-						while (low <= high) {
-							auto& ln = pti->snames[low].name;
-							auto& hn = pti->snames[high].name;
-							if (idx >= ln.size() || ln[idx] < c) {
-								low++;
-								continue;
-							} else if (idx >= hn.size() || hn[idx] > c) {
-								high--;
-								continue;
-							} else break;
-						}
-						idx++;
-					}
-				public:
-					virtual member_location_result feed(char c) {
-						feedone(c);
-						if (low > high) {
-							return member_location_result::not_found;
-						} else if (pti->snames[low].name.size() == idx) {
-							return member_location_result::found;
-						} else return member_location_result::not_done;
-					};
-
-					virtual bool operator()() {
-						if (low > high) {
-							return false;
-						} else if (pti->snames[low].name.size() == idx) {
-							pti->member_apply(bp, pti->snames[low].idx, fn);
-							return true;
-						} else {
-							return false;
-						}
-					}
-					//virtual bool operator()(const char* n, int len = -1) {
-					//	if (len == -1)
-					//		len = (int)strlen(n);
-					//	for (int i = 0; i < len; i++)
-					//		feedone(n[i]);
-					//	return operator()();
-					//}
-					virtual bool operator()(const char* n, size_t len=-1) {
-						if (len == -1)
-							len = strlen(n);
-						for (size_t i = 0; i < len; i++)
-							feedone(n[i]);
-						return operator()();
-					}
-					loc_impl(const t_ti* ipti,BASE *ibp, const F& ifn) : pti(ipti),bp(ibp) , fn(ifn),idx(0), low(0), high(sizeof...(R)-1) {}
-				};
+			class matcher : public name_matcher {
+			public:
+				constexpr matcher(const t_ti* ipti) : name_matcher(ipti->snames.data(), sizeof...(R)) {}
+			};
 
-				return loc_impl{ this,bp,fn };
+			// index (in declaration order) of the named member or -1
+			constexpr int find(const char* n, size_t len) const {
+				return find_name(snames.data(), sizeof...(R), std::string_view(n, len));
 			}
 
 			template<class F>
@@ -191,7 +283,37 @@ namespace rpoco2 {
 				foreach_impl(bp, fn, std::make_index_sequence<sizeof...(R)>());
 			}
 
-			constexpr t_ti(NAMES i_names, NAMES i_snames, TNAME i_mem) : names(i_names), snames(i_snames), members(i_mem)
+			// compile-time access to the declared members (in declaration order)
+			static constexpr std::size_t count = sizeof...(R);
+
+			template<std::size_t I>
+			using member_type = std::tuple_element_t<I, std::tuple<R...>>;
+
+			template<std::size_t I>
+			using member_options = std::tuple_element_t<I, std::tuple<O...>>;
+
+			// the (member pointer, options) tuple of a member
+			template<std::size_t I>
+			constexpr auto member() const {
+				return std::get<I>(members);
+			}
+			template<std::size_t I>
+			constexpr auto member_ptr() const {
+				return std::get<0>(std::get<I>(members));
+			}
+			constexpr const NAMES& member_names() const {
+				return names;
+			}
+			constexpr const NAMES& sorted_names() const {
+				return snames;
+			}
+
+			// a copy that answers member_at from the given descriptor table
+			constexpr t_ti with_descs(const member_desc& (*i_desc_at)(int)) const {
+				return t_ti{ names, snames, members, i_desc_at };
+			}
+
+			constexpr t_ti(NAMES i_names, NAMES i_snames, TNAME i_mem, const member_desc& (*i_desc_at)(int) = nullptr) : names(i_names), snames(i_snames), members(i_mem), desc_at(i_desc_at)
 				//,members(itup)
 			{}
 		};
@@ -204,6 +326,127 @@ namespace rpoco2 {
 			return t_ti<BASE,NAMES,TNAME>{ names,snames,r };
 		}
 
+		// true for types declared with the RPOCO2 macro
+		template<class T, class = void>
+		struct is_rpoco : std::false_type {};
+		template<class T>
+		struct is_rpoco<T, std::void_t<decltype(T::rpoco2_type_info_make())>> : std::true_type {};
+		template<class T>
+		inline constexpr bool is_rpoco_v = is_rpoco<T>::value;
+
+		template<class T>
+		const member_desc& member_desc_at(int idx);
+
+		// the type-info of an RPOCO2 type as a constant expression
+		template<class T>
+		inline constexpr auto tinfo = T::rpoco2_type_info_make().with_descs(&member_desc_at<T>);
+
+		template<auto MP, class P>
+		constexpr bool member_ptr_equal(P p) {
+			if constexpr (std::is_same_v<decltype(MP), P>)
+				return MP == p;
+			else
+				return false;
+		}
+
+		template<class T, auto MP, std::size_t ... I>
+		constexpr int member_index_impl(std::index_sequence<I...>) {
+			int rv = -1;
+			((rv = (rv < 0 && member_ptr_equal<MP>(tinfo<T>.template member_ptr<I>())) ? (int)I : rv), ...);
+			return rv;
+		}
+
+		// declaration index of the member pointer MP in T or -1 if it isn't declared
+		template<class T, auto MP>
+		constexpr int member_index() {
+			return member_index_impl<T, MP>(std::make_index_sequence<std::remove_const_t<decltype(tinfo<T>)>::count>());
+		}
+
+		// byte offset of a member of a standard layout type, computed like offsetof (which needs the member name
+		// rather than a member pointer), other types have to go through the member pointer
+		template<class B, class M>
+		inline std::size_t member_offset(M B::* mp) {
+			static_assert(std::is_standard_layout_v<B>, "member offsets are only defined for standard layout types");
+			alignas(B) unsigned char storage[sizeof(B)];
+			const B* bp = reinterpret_cast<const B*>(storage);
+			return reinterpret_cast<const unsigned char*>(&(bp->*mp)) - storage;
+		}
+
+		// member I of an RPOCO2 object through its member pointer
+		template<class T, std::size_t I>
+		void* member_access(void* obj) {
+			return &(static_cast<T*>(obj)->*(tinfo<T>.template member_ptr<I>()));
+		}
+
+		template<class M>
+		constexpr member_kind kind_of() {
+			if constexpr (std::is_same_v<M, bool>)
+				return member_kind::boolean;
+			else if constexpr (std::is_integral_v<M> && std::is_signed_v<M>)
+				return member_kind::signed_int;
+			else if constexpr (std::is_integral_v<M>)
+				return member_kind::unsigned_int;
+			else if constexpr (std::is_floating_point_v<M>)
+				return member_kind::floating;
+			else if constexpr (std::is_array_v<M> && std::is_same_v<std::remove_extent_t<M>, char>)
+				return member_kind::chars;
+			else if constexpr (is_rpoco_v<M>)
+				return member_kind::object;
+			else
+				return member_kind::other;
+		}
+
+		template<class O>
+		struct option_types;
+		template<class... O>
+		struct option_types<std::tuple<O...>> {
+			static constexpr const std::type_info* list[] = { &typeid(O)..., nullptr };
+		};
+
+		template<class T, std::size_t I>
+		constexpr member_desc make_member_desc() {
+			using TI = std::remove_const_t<decltype(tinfo<T>)>;
+			using M = typename TI::template member_type<I>;
+			const type_info* nested = nullptr;
+			if constexpr (is_rpoco_v<M>)
+				nested = &tinfo<M>;
+			return member_desc{ tinfo<T>.member_names()[I].name, &member_access<T, I>, member_desc::npos, sizeof(M), kind_of<M>(), std::is_trivially_copyable_v<M>,
+				&typeid(M), nested, option_types<typename TI::template member_options<I>>::list };
+		}
+
+		template<class T, std::size_t ... I>
+		constexpr std::array<member_desc, sizeof...(I)> make_member_descs(std::index_sequence<I...>) {
+			return { make_member_desc<T, I>()... };
+		}
+
+		// the member descriptors of an RPOCO2 type, built at compile time. Offsets can't be computed in a constant
+		// expression so they are npos here and filled in by member_desc_at
+		template<class T>
+		inline constexpr auto member_descs = make_member_descs<T>(std::make_index_sequence<std::remove_const_t<decltype(tinfo<T>)>::count>());
+
+		template<class T, std::size_t ... I>
+		std::array<member_desc, sizeof...(I)> make_member_descs_with_offsets(std::index_sequence<I...>) {
+			auto rv = member_descs<T>;
+			if constexpr (std::is_standard_layout_v<T>)
+				((rv[I].offset = member_offset(tinfo<T>.template member_ptr<I>())), ...);
+			return rv;
+		}
+
+		// the descriptor table type-infos hand out, offsets of standard layout types are cached on first use
+		template<class T>
+		const member_desc& member_desc_at(int idx) {
+			static const auto descs = make_member_descs_with_offsets<T>(std::make_index_sequence<std::remove_const_t<decltype(tinfo<T>)>::count>());
+			return descs[idx];
+		}
+
+		// does the option tuple of a member contain a flag of type F
+		template<class F, class O>
+		struct has_opt;
+		template<class F, class... O>
+		struct has_opt<F, std::tuple<O...>> : std::bool_constant<(std::is_same_v<F, O> || ...)> {};
+		template<class F, class O>
+		inline constexpr bool has_opt_v = has_opt<F, O>::value;
+
 		enum class parse_state {
 			DEF=0,           // default state
 			OPTTOK,          // if we're parsing a member opt{
@@ -222,16 +465,8 @@ namespace rpoco2 {
 			return false;
 		}
 
-		// keep track of name and original index (to lookup the actual sym)
-		struct nameidx {
-			std::string_view name;
-			int idx;
-
-			constexpr nameidx():name(),idx() {}
-		};
-
 		// just a small specialized bubblesort (no constexpr std::sort in C++ 17)
-		template<int COUNT>
+		template<std::size_t COUNT>
 		constexpr auto sort(std::array<nameidx,COUNT> iv) {
 			bool sorted=false;
 			while(!sorted) {
@@ -270,7 +505,7 @@ namespace rpoco2 {
 				switch (state) {
 				case parse_state::DEF: {
 					if (c == ',')
-						throw std::exception("comma not expected without name");
+						throw std::logic_error("comma not expected without name");
 					if (isspace(c))
 						continue;
 					else if (c == '&' || c == 'o') {
@@ -284,13 +519,13 @@ namespace rpoco2 {
 						nc++;
 						ns = i + 1;
 						continue;
-					} else throw std::exception("RPOCO can only contain pointer to members OR opt's with pointer to members");
+					} else throw std::logic_error("RPOCO can only contain pointer to members OR opt's with pointer to members");
 				}
 				case parse_state::OPTTOK: {
 					int ofs = i - (ns - 1);
 					if (ofs < 3) {
 						if ("opt"[ofs] != c) {
-							throw std::exception("RPOCO can only contain pointer to members OR opt's with pointer to members");
+							throw std::logic_error("RPOCO can only contain pointer to members OR opt's with pointer to members");
 						} else continue;
 					}
 					if (isspace(c)) {
@@ -301,7 +536,7 @@ namespace rpoco2 {
 						continue;
 					} else {
 						//static_assert(0, "Invalid char after opt");
-						throw std::exception("Invalid char after opt");
+						throw std::logic_error("Invalid char after opt");
 					}
 				}
 				case parse_state::PREOPTNAME:
@@ -311,7 +546,7 @@ namespace rpoco2 {
 						ns = i + 1;
 						state = parse_state::TNAME;
 						continue;
-					} else throw new std::exception("opt{ must be followed by a member pointer");
+					} else throw std::logic_error("opt{ must be followed by a member pointer");
 				case parse_state::TNAME: {
 					if (c == ':') {
 						ns = i + 1;
@@ -336,7 +571,7 @@ namespace rpoco2 {
 						state=parse_state::DEF;
 						continue;
 					}
-					throw std::exception("comma or spaces must be after name");
+					throw std::logic_error("comma or spaces must be after name");
 				case parse_state::OPTDATA: {
 					int eOpt = optType == '{' ? '}' : ')';
 					if (c == '\"') {
@@ -369,7 +604,7 @@ namespace rpoco2 {
 						continue;
 					}
 				default:
-					throw std::exception("bad state");
+					throw std::logic_error("bad state");
 				}
 				//nc+=sv[i];
 			}
@@ -383,5 +618,5 @@ namespace rpoco2 {
 	};
 };
 
-#endif __INCLUDED_RPOCO2_HPP__
+#endif // __INCLUDED_RPOCO2_HPP__
 
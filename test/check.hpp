@@ -0,0 +1,15 @@
+#pragma once
+
+// minimal checks for the behavior tests, a failed check is reported and the test exits non-zero
+#include <cstdio>
+
+static int check_failures = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		check_failures++; \
+	} \
+} while (0)
+
+#define CHECK_RESULT() (check_failures ? 1 : 0)
@@ -0,0 +1,64 @@
+// columns<T> storage and parsing records straight into columns
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_columns.hpp>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Point {
+	int x = 5;
+	double y = 1.5;
+	bool on = true;
+	int rgb[3] = { 1, 2, 3 };
+	std::string name = "none";
+	RPOCO2(&Point::x, &Point::y, &Point::on, &Point::rgb, &Point::name);
+};
+
+int main() {
+	{
+		columns<Point> c;
+		Point p;
+		p.x = 10;
+		p.name = "ten";
+		c.push_back(p);
+		c.emplace_row();
+		CHECK(c.size() == 2);
+		CHECK(c.column<&Point::x>()[0] == 10 && c.column<0>()[0] == 10);
+		CHECK(c.column<&Point::name>()[0] == "ten");
+
+		// new rows take the default member initializers
+		CHECK(c.column<&Point::x>()[1] == 5 && c.column<&Point::y>()[1] == 1.5);
+		CHECK(c.column<&Point::on>()[1] && c.column<&Point::rgb>()[1][2] == 3 && c.column<&Point::name>()[1] == "none");
+
+		Point back = c.row(0);
+		CHECK(back.x == 10 && back.name == "ten" && back.rgb[1] == 2);
+		c.clear();
+		CHECK(c.size() == 0 && c.column<&Point::x>().empty());
+	}
+	{
+		columns<Point> c;
+		CHECK(json::parse(c, R"([{"x":1,"y":2,"on":false,"rgb":[4,5,6],"name":"a"},{},{"name":"c","other":[1,{}]}])"));
+		CHECK(c.size() == 3);
+		auto& x = c.column<&Point::x>();
+		auto& name = c.column<&Point::name>();
+		CHECK(x.size() == 3 && name.size() == 3);
+		CHECK(x[0] == 1 && !c.column<&Point::on>()[0] && c.column<&Point::rgb>()[0][2] == 6 && name[0] == "a");
+
+		// members missing from a record match what the row-wise parse gives
+		Point rowwise;
+		CHECK(json::parse(rowwise, "{}"));
+		Point r1 = c.row(1);
+		CHECK(r1.x == rowwise.x && r1.y == rowwise.y && r1.on == rowwise.on && r1.name == rowwise.name);
+		CHECK(r1.x == 5 && r1.rgb[0] == 1);
+		CHECK(x[2] == 5 && name[2] == "c");
+
+		// parsing again replaces the rows like it does for vectors
+		CHECK(json::parse(c, R"([{"x":7}])"));
+		CHECK(c.size() == 1 && c.column<&Point::x>()[0] == 7 && c.column<&Point::name>().size() == 1);
+
+		CHECK(!json::parse(c, R"([{"x":"not a number"}])"));
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,37 @@
+// must not compile for NARROWING_CASE 1 and 2: strict conversion rejects narrowing members
+// (NARROWING_CASE 0 is the control that does compile)
+
+#include <rpoco2/convert.hpp>
+
+#include <cstdint>
+
+struct Src {
+	double value = 0;
+	std::int64_t count = 0;
+	RPOCO2(&Src::value, &Src::count);
+};
+
+#if NARROWING_CASE == 1
+struct Dst {
+	int value = 0;          // double to int
+	RPOCO2(&Dst::value);
+};
+#elif NARROWING_CASE == 2
+struct Dst {
+	std::int8_t count = 0;  // int64_t to int8_t
+	RPOCO2(&Dst::count);
+};
+#else
+struct Dst {
+	double value = 0;
+	std::int64_t count = 0;
+	RPOCO2(&Dst::value, &Dst::count);
+};
+#endif
+
+int main() {
+	Src s;
+	Dst d = rpoco2::convert<Dst>(s);
+	(void)d;
+	return 0;
+}
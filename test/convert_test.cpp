@@ -0,0 +1,147 @@
+// member-wise conversion between RPOCO2 types
+
+#include <rpoco2/convert.hpp>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct PointDto {
+	int x = 0;
+	int y = 0;
+	RPOCO2(&PointDto::x, &PointDto::y);
+};
+
+struct Point {
+	long long x = 0;   // widening is fine in strict mode
+	long y = 0;
+	RPOCO2(&Point::x, &Point::y);
+};
+
+struct OrderDto {
+	std::string id;
+	int qty = 0;
+	double price = 0;
+	PointDto at;
+	std::vector<PointDto> path;
+	std::map<std::string, int> counts;
+	std::optional<PointDto> maybe;
+	std::unique_ptr<PointDto> owned;
+	std::shared_ptr<PointDto> shared;
+	int grid[2] = { 0, 0 };
+	RPOCO2(&OrderDto::id, &OrderDto::qty, &OrderDto::price, &OrderDto::at, &OrderDto::path, &OrderDto::counts,
+		&OrderDto::maybe, &OrderDto::owned, &OrderDto::shared, &OrderDto::grid);
+};
+
+struct Order {
+	std::string id;
+	long qty = 0;
+	double price = 0;
+	Point at;
+	std::vector<Point> path;
+	std::map<std::string, long long> counts;
+	std::optional<Point> maybe;
+	std::unique_ptr<Point> owned;
+	std::shared_ptr<Point> shared;
+	std::array<long, 2> grid{};
+	RPOCO2(&Order::id, &Order::qty, &Order::price, &Order::at, &Order::path, &Order::counts,
+		&Order::maybe, &Order::owned, &Order::shared, &Order::grid);
+};
+
+// a stateful deleter that counts the deletions it performs
+struct counted_delete {
+	int* count = nullptr;
+	void operator()(Point* p) const {
+		if (count)
+			++*count;
+		delete p;
+	}
+};
+
+struct Holder {
+	std::unique_ptr<Point, counted_delete> owned;
+	RPOCO2(&Holder::owned);
+};
+
+struct HolderDto {
+	std::unique_ptr<PointDto> owned;
+	RPOCO2(&HolderDto::owned);
+};
+
+// a narrowed copy of Order, only convertible leniently
+struct Summary {
+	int qty = -1;
+	float price = -1;
+	std::int8_t small = 3;
+	std::string missing = "kept";
+	RPOCO2(&Summary::qty, &Summary::price, &Summary::small, &Summary::missing);
+};
+
+struct Wide {
+	double qty = 2.5;
+	long long price = 7;
+	std::int64_t small = 300;
+	RPOCO2(&Wide::qty, &Wide::price, &Wide::small);
+};
+
+static_assert(impl2::is_narrowing_v<int, double> && impl2::is_narrowing_v<std::int8_t, std::int64_t> && impl2::is_narrowing_v<float, double>);
+static_assert(!impl2::is_narrowing_v<double, float> && !impl2::is_narrowing_v<long long, int> && !impl2::is_narrowing_v<std::string, std::string>);
+static_assert(!impl2::can_convert_v<convert_mode::strict, int, const double&> && impl2::can_convert_v<convert_mode::lenient, int, const double&>);
+static_assert(!impl2::can_convert_v<convert_mode::strict, std::vector<int>, const std::vector<double>&>);
+static_assert(impl2::can_convert_v<convert_mode::strict, std::vector<long long>, const std::vector<int>&>);
+// integers to floating point narrow by the brace initialization rules as well
+static_assert(!impl2::can_convert_v<convert_mode::strict, double, const int&>);
+
+int main() {
+	{
+		OrderDto dto;
+		dto.id = "o-1";
+		dto.qty = 3;
+		dto.price = 9.5;
+		dto.at = { 1, 2 };
+		dto.path = { { 3, 4 }, { 5, 6 } };
+		dto.counts = { { "a", 1 } };
+		dto.maybe = PointDto{ 7, 8 };
+		dto.owned = std::make_unique<PointDto>(PointDto{ 9, 10 });
+		dto.grid[1] = 11;
+
+		Order o = convert<Order>(dto);
+		CHECK(o.id == "o-1" && o.qty == 3 && o.price == 9.5);
+		CHECK(o.at.x == 1 && o.at.y == 2);
+		CHECK(o.path.size() == 2 && o.path[1].x == 5 && o.path[1].y == 6);
+		CHECK(o.counts["a"] == 1);
+		CHECK(o.maybe && o.maybe->y == 8);
+		CHECK(o.owned && o.owned->x == 9);
+		CHECK(!o.shared);
+		CHECK(o.grid[1] == 11);
+		CHECK(dto.id == "o-1");
+
+		// moving from an rvalue source
+		Order moved = convert<Order>(std::move(dto));
+		CHECK(moved.id == "o-1" && moved.path.size() == 2);
+	}
+	{
+		// lenient mode narrows and leaves members without a source alone
+		Wide w;
+		Summary s;
+		convert_into<convert_mode::lenient>(s, w);
+		CHECK(s.qty == 2 && s.price == 7 && s.small == (std::int8_t)300 && s.missing == "kept");
+	}
+	{
+		// unique_ptr's with other deleters are allocated in place and keep their deleter
+		int deleted = 0;
+		HolderDto dto;
+		dto.owned = std::make_unique<PointDto>(PointDto{ 1, 2 });
+		Holder h;
+		h.owned = std::unique_ptr<Point, counted_delete>(new Point(), counted_delete{ &deleted });
+		convert_into(h, dto);
+		CHECK(h.owned && h.owned->y == 2 && deleted == 1 && h.owned.get_deleter().count == &deleted);
+		h.owned.reset();
+		CHECK(deleted == 2);
+	}
+	return CHECK_RESULT();
+}
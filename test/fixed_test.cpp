@@ -0,0 +1,71 @@
+// fixed_string, fixed_vector, std::optional and std::unique_ptr as parse targets
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_fixed.hpp>
+
+#include <stdexcept>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Item {
+	int id = 0;
+	RPOCO2(&Item::id);
+};
+
+struct Record {
+	fixed_string<4> name;
+	fixed_vector<int, 3> values;
+	std::optional<Item> item;
+	std::unique_ptr<Item> owned;
+	RPOCO2(&Record::name, &Record::values, &Record::item, &Record::owned);
+};
+
+int main() {
+	{
+		Record r;
+		CHECK(json::parse(r, R"({"name":"ab","values":[1,2],"item":{"id":3},"owned":{"id":4}})"));
+		CHECK(r.name.view() == "ab" && r.name.size() == 2);
+		CHECK(r.values.size() == 2 && r.values[0] == 1 && r.values[1] == 2);
+		CHECK(r.item && r.item->id == 3);
+		CHECK(r.owned && r.owned->id == 4);
+
+		// parsing again replaces the contents instead of appending to them
+		CHECK(json::parse(r, R"({"name":"cd","values":[5,6,7]})"));
+		CHECK(r.name.view() == "cd");
+		CHECK(r.values.size() == 3 && r.values[0] == 5 && r.values[2] == 7);
+		CHECK(json::parse(r, R"({"name":"wxyz"})"));
+		CHECK(r.name.view() == "wxyz");
+
+		// absent members are kept, null resets
+		CHECK(r.item && r.owned);
+		CHECK(json::parse(r, R"({"item":null,"owned":null})"));
+		CHECK(!r.item && !r.owned);
+	}
+	{
+		// content that doesn't fit fails the parse
+		Record r;
+		CHECK(!json::parse(r, R"({"name":"abcde"})"));
+		CHECK(!json::parse(r, R"({"values":[1,2,3,4]})"));
+		CHECK(r.values.size() == 3);
+	}
+	{
+		fixed_string<3> s("abc");
+		CHECK(s.full() && s == fixed_string<3>("abc"));
+		CHECK(!s.push_back('d') && s.view() == "abc");
+		bool thrown = false;
+		try {
+			fixed_string<3> t("abcd");
+		} catch (const std::length_error&) {
+			thrown = true;
+		}
+		CHECK(thrown);
+
+		fixed_vector<std::string, 2> v;
+		CHECK(v.push_back("a") && v.push_back("b") && !v.push_back("c"));
+		fixed_vector<std::string, 2> copy = v;
+		CHECK(copy == v && copy.size() == 2 && copy[1] == "b");
+	}
+	return CHECK_RESULT();
+}
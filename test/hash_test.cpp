@@ -0,0 +1,138 @@
+// member-wise hashing, equality and ordering
+
+#include <rpoco2/hash.hpp>
+
+#include <cmath>
+#include <limits>
+#include <new>
+#include <set>
+#include <unordered_map>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Point {
+	int x, y;
+	RPOCO2(&Point::x, &Point::y);
+};
+static_assert(impl2::bulk<Point>(), "a fully declared standard layout type is hashed in bulk");
+
+struct Key {
+	char name[16];
+	double weight;
+	std::vector<Point> path;
+	std::map<std::string, int> attrs;
+	std::optional<Point> anchor;
+	std::shared_ptr<Point> ref;
+	fixed_string<8> code;
+	int cache;
+	RPOCO2(&Key::name, &Key::weight, &Key::path, &Key::attrs, &Key::anchor, &Key::ref, &Key::code,
+		opt{ &Key::cache, rpoco2::nohash });
+};
+
+struct Wide {
+	long double v = 1.0L;
+	RPOCO2(&Wide::v);
+};
+
+static Key make_key() {
+	Key k{};
+	memset(k.name, 'z', sizeof(k.name));
+	strcpy(k.name, "key");
+	k.weight = 1.5;
+	k.path = { { 1, 2 }, { 3, 4 } };
+	k.attrs = { { "a", 1 } };
+	k.anchor = Point{ 5, 6 };
+	k.ref = std::make_shared<Point>(Point{ 7, 8 });
+	k.code.append("c", 1);
+	k.cache = 1;
+	return k;
+}
+
+int main() {
+	Key a = make_key(), b = make_key();
+
+	// bytes after the name terminator, the nohash member and pointee identity don't matter
+	memset(b.name + 4, 'q', sizeof(b.name) - 4);
+	b.cache = 2;
+	b.ref = std::make_shared<Point>(Point{ 7, 8 });
+	CHECK(equal(a, b) && compare(a, b) == 0 && hash_value(a) == hash_value(b));
+
+	// -0.0 equals 0.0 so it hashes the same
+	a.weight = 0.0;
+	b.weight = -0.0;
+	CHECK(equal(a, b) && hash_value(a) == hash_value(b));
+
+	// NaNs of any sign or payload equal each other, hash the same and order after numbers
+	a.weight = std::numeric_limits<double>::quiet_NaN();
+	b.weight = -std::nan("1");
+	CHECK(equal(a, a) && equal(a, b) && compare(a, b) == 0 && hash_value(a) == hash_value(b));
+	b.weight = std::numeric_limits<double>::infinity();
+	CHECK(!equal(a, b) && compare(a, b) > 0 && compare(b, a) < 0);
+	{
+		std::unordered_map<Key, int, rpoco2::hash<Key>, rpoco2::equal_to<Key>> nan_map;
+		nan_map[a] = 1;
+		CHECK(nan_map.count(a) == 1 && nan_map.size() == 1);
+	}
+
+	// long double padding bytes don't take part
+	{
+		alignas(Wide) unsigned char sa[sizeof(Wide)], sb[sizeof(Wide)];
+		memset(sa, 0x00, sizeof(sa));
+		memset(sb, 0xA5, sizeof(sb));
+		Wide* wa = new (sa) Wide;
+		Wide* wb = new (sb) Wide;
+		CHECK(equal(*wa, *wb) && hash_value(*wa) == hash_value(*wb));
+		wb->v = 1.5L;
+		CHECK(!equal(*wa, *wb) && hash_value(*wa) != hash_value(*wb));
+		wa->v = -0.0L;
+		wb->v = 0.0L;
+		CHECK(equal(*wa, *wb) && hash_value(*wa) == hash_value(*wb));
+	}
+
+	// every hashed member takes part
+	b = make_key();
+	a = make_key();
+	b.path[1].y = 5;
+	CHECK(!equal(a, b) && compare(a, b) < 0 && compare(b, a) > 0 && hash_value(a) != hash_value(b));
+	b = make_key();
+	b.attrs["b"] = 0;
+	CHECK(!equal(a, b) && compare(a, b) < 0 && hash_value(a) != hash_value(b));
+	b = make_key();
+	b.anchor.reset();
+	CHECK(!equal(a, b) && compare(b, a) < 0);
+	b = make_key();
+	b.ref.reset();
+	CHECK(!equal(a, b) && compare(b, a) < 0);
+	b = make_key();
+	b.code.append("d", 1);
+	CHECK(!equal(a, b) && compare(a, b) < 0);
+
+	// ordering goes by declaration order, shorter prefixes first
+	b = make_key();
+	strcpy(b.name, "kez");
+	b.weight = 0;
+	CHECK(compare(a, b) < 0);
+	strcpy(b.name, "ke");
+	CHECK(compare(b, a) < 0);
+
+	// bulk hashed types
+	CHECK(hash_value(Point{ 1, 2 }) == hash_value(Point{ 1, 2 }) && hash_value(Point{ 1, 2 }) != hash_value(Point{ 2, 1 }));
+	CHECK(compare(Point{ 1, 9 }, Point{ 2, 0 }) < 0);
+
+	// functors in the standard containers
+	std::unordered_map<Key, int, rpoco2::hash<Key>, rpoco2::equal_to<Key>> um;
+	um[make_key()] = 1;
+	Key c = make_key();
+	c.cache = 42;
+	CHECK(um.count(c) == 1);
+	c.weight = 2;
+	um[c] = 2;
+	CHECK(um.size() == 2);
+
+	std::set<Point, rpoco2::less<Point>> s{ { 2, 0 }, { 1, 9 }, { 1, 2 }, { 1, 2 } };
+	CHECK(s.size() == 3 && s.begin()->x == 1 && s.begin()->y == 2);
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,77 @@
+// string interning, directly and through the json parser
+
+#include <rpoco2/json_intern.hpp>
+#include <rpoco2/json_std_vector.hpp>
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Tagged {
+	interned kind;
+	std::vector<interned> tags;
+	RPOCO2(&Tagged::kind, &Tagged::tags);
+};
+
+int main() {
+	{
+		intern_pool pool;
+		std::string a = "alpha";
+		interned x(a, pool), y(std::string_view("alpha"), pool), z("beta", pool);
+		a[0] = 'A';
+		// the pool keeps its own copy and equal strings share it
+		CHECK(x.view() == "alpha" && x.c_str() == y.c_str() && x == y && x != z);
+		CHECK(x.hash() == std::hash<std::string_view>{}("alpha") && std::hash<interned>{}(x) == x.hash());
+		CHECK(x < z && !(z < x) && !(x < y));
+		CHECK(interned().empty() && interned("", pool).empty() && interned() == interned("", pool) && *interned().c_str() == 0);
+
+		// handles from different pools compare by content
+		intern_pool other;
+		CHECK(interned("alpha", other) == x && interned("alpha", other).c_str() != x.c_str());
+
+		auto st = pool.stats();
+		CHECK(st.lookups == 3 && st.hits == 1 && st.unique == 2 && st.bytes == 9);
+
+		std::unordered_set<interned> set{ x, y, z };
+		CHECK(set.size() == 2);
+	}
+	{
+		// direct, escaped and long (spilled) strings parse to the same pooled strings
+		std::string longs(300, 'x');
+		std::string src = R"({"kind":"ABC","tags":["ABC","x\"y",")" + longs + R"(",")" + longs.substr(0, 150) + "\\u0078" + longs.substr(0, 149) + R"("]})";
+		Tagged t;
+		CHECK(json::parse(t, src.c_str()));
+		CHECK(t.kind.view() == "ABC" && t.tags.size() == 4);
+		CHECK(t.tags[0] == t.kind && t.tags[0].c_str() == t.kind.c_str());
+		CHECK(t.tags[1].view() == "x\"y");
+		CHECK(t.tags[2].view() == longs && t.tags[3].c_str() == t.tags[2].c_str());
+		CHECK(!json::parse(t, R"({"kind":"a\q"})"));
+	}
+	{
+		// concurrent interning yields one entry per string
+		intern_pool pool;
+		const int threads = 4, count = 2000;
+		std::vector<std::vector<const char*>> seen(threads);
+		std::vector<std::thread> ts;
+		for (int i = 0; i < threads; i++) {
+			ts.emplace_back([&, i]() {
+				for (int j = 0; j < count; j++)
+					seen[i].push_back(interned(std::to_string((j * 7 + i) % 500), pool).c_str());
+			});
+		}
+		for (auto& t : ts)
+			t.join();
+		bool same = true;
+		for (int i = 0; i < threads; i++)
+			for (int j = 0; j < count; j++)
+				same &= seen[i][j] == interned(std::to_string((j * 7 + i) % 500), pool).c_str();
+		CHECK(same);
+		auto st = pool.stats();
+		CHECK(st.unique == 500 && st.lookups == 2 * threads * count && st.hits == st.lookups - 500);
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,129 @@
+// json::parse and json::parse_constexpr into arrays and numbers
+
+#include <rpoco2/json_std.hpp>
+
+#include <cstdlib>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Arrays {
+	int arr[2] = { 0, 0 };
+	std::array<int, 2> std_arr{};
+	RPOCO2(&Arrays::arr, &Arrays::std_arr);
+};
+
+struct Numbers {
+	double d = 0;
+	float f = 0;
+	int i = 0;
+	RPOCO2(&Numbers::d, &Numbers::f, &Numbers::i);
+};
+
+struct Text {
+	std::string s;
+	char c[16] = {};
+	RPOCO2(&Text::s, &Text::c);
+};
+
+struct Keys {
+	int ab = 0;
+	int a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x = 0;
+	RPOCO2(&Keys::ab, &Keys::a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x);
+};
+
+struct Chars {
+	char c[8] = {};
+	RPOCO2(&Chars::c);
+};
+
+static double number(const char* text) {
+	Numbers n;
+	std::string doc = std::string("{\"d\":") + text + "}";
+	CHECK(json::parse(n, doc.c_str()));
+	return n.d;
+}
+
+int main() {
+	{
+		Arrays a;
+		CHECK(json::parse(a, R"({"arr":[1,2],"std_arr":[3,4]})"));
+		CHECK(a.arr[0] == 1 && a.arr[1] == 2);
+		CHECK(a.std_arr[0] == 3 && a.std_arr[1] == 4);
+	}
+	{
+		// more elements than the array holds fail instead of writing past it
+		Arrays a;
+		CHECK(!json::parse(a, R"({"arr":[1,2,3,4,5,6,7,8,9,10,11,12]})"));
+		CHECK(!json::parse(a, R"({"std_arr":[1,2,3]})"));
+	}
+	{
+		// large powers of ten don't pick up rounding errors and subnormals survive
+		for (int e = -320; e <= 300; e++) {
+			std::string text = "1e" + std::to_string(e);
+			CHECK(number(text.c_str()) == strtod(text.c_str(), nullptr));
+		}
+		CHECK(number("0.1") == 0.1 && number("1.7976931348623157e308") == 1.7976931348623157e308);
+		CHECK(number("1e100") == 1e100 && number("1e-200") == 1e-200);
+		CHECK(number("1e-310") == 1e-310);
+		Numbers n;
+		CHECK(json::parse(n, R"({"f":1.5e10,"i":-42})"));
+		CHECK(n.f == 1.5e10f && n.i == -42);
+	}
+	{
+		// an unpaired high surrogate followed by another escape, the escape is still decoded
+		const char* src = R"({"s":"a\uD83D\nb","c":"a\uD83D\u0041"})";
+		Text t;
+		CHECK(!json::parse(t, src));
+		json::parse_options options;
+		options.utf8 = json::utf8_mode::replace;
+		CHECK(json::parse(t, src, -1, options));
+		CHECK(t.s == "a\xEF\xBF\xBD\nb" && std::string(t.c) == "a\xEF\xBF\xBD" "A");
+		options.utf8 = json::utf8_mode::pass;
+		CHECK(json::parse(t, src, -1, options));
+		CHECK(t.s == "a\xED\xA0\xBD\nb" && std::string(t.c) == "a\xED\xA0\xBD" "A");
+		CHECK(json::parse(t, R"({"s":"\uD83D\uD83D\uDE00\t"})", -1, options) && t.s == "\xED\xA0\xBD\xF0\x9F\x98\x80\t");
+	}
+	{
+		// keys are matched in place, escaped keys go through the streaming matcher
+		const std::string long_name = "a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x";
+		Keys k;
+		CHECK(json::parse(k, R"({"\u0061b":3})") && k.ab == 3);
+		CHECK(json::parse(k, ("{\"" + long_name + "\":4}").c_str()) && k.a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x == 4);
+		CHECK(json::parse(k, ("{\"\\u0061" + long_name.substr(1) + "\":5}").c_str()) && k.a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x == 5);
+		// longer or shorter than a member name doesn't match it
+		CHECK(json::parse(k, ("{\"" + long_name + "y\":6,\"" + long_name.substr(1) + "\":7,\"a\":8}").c_str()));
+		CHECK(k.a_member_name_well_past_the_hundred_bytes_that_keys_used_to_be_copied_into_before_they_were_matched_in_place_x == 5 && k.ab == 3);
+		// long unknown keys, plain and escaped, are skipped
+		std::string unknown;
+		for (int i = 0; i < 30; i++)
+			unknown += "k\\u0078y\\n";
+		CHECK(unknown.size() == 300);
+		CHECK(json::parse(k, ("{\"" + unknown + "\":[1],\"" + std::string(300, 'z') + "\":{},\"ab\":9}").c_str()) && k.ab == 9);
+		constexpr auto ck = json::parse_constexpr<Keys>(R"({"a\u0062":10,"\u0061\u0062c":11})");
+		static_assert(ck.ab == 10);
+	}
+	{
+		constexpr auto a = json::parse_constexpr<Arrays>(R"({"arr":[7,8],"std_arr":[9,10]})");
+		static_assert(a.arr[1] == 8 && a.std_arr[0] == 9);
+		constexpr auto n = json::parse_constexpr<Numbers>(R"({"d":2.5e2,"i":3})");
+		static_assert(n.d == 250 && n.i == 3);
+		constexpr json::parse_options replace{ json::utf8_mode::replace };
+		constexpr auto c = json::parse_constexpr<Chars>(R"({"c":"\uD83D\/"})", replace);
+		static_assert(c.c[0] == '\xEF' && c.c[2] == '\xBD' && c.c[3] == '/' && c.c[4] == 0);
+
+		// exponents at the ends of the double range compile and match runtime parsing
+		constexpr auto big = json::parse_constexpr<Numbers>(R"({"d":1e256})");
+		constexpr auto small = json::parse_constexpr<Numbers>(R"({"d":1e-300})");
+		constexpr auto max = json::parse_constexpr<Numbers>(R"({"d":1.7976931348623157e308})");
+		constexpr auto above_exact = json::parse_constexpr<Numbers>(R"({"d":1e23})");
+		constexpr auto subnormal = json::parse_constexpr<Numbers>(R"({"d":4.9e-324})");
+		CHECK(big.d == number("1e256"));
+		CHECK(small.d == number("1e-300"));
+		CHECK(max.d == number("1.7976931348623157e308"));
+		CHECK(above_exact.d == number("1e23"));
+		CHECK(subnormal.d == number("4.9e-324") && subnormal.d > 0);
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,98 @@
+// RFC 7386 merge patches applied in place
+
+#include <rpoco2/json_patch.hpp>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Author {
+	std::string name;
+	int age = 30;
+	RPOCO2(&Author::name, &Author::age);
+};
+
+struct Doc {
+	std::string title = "untitled";
+	int version = 1;
+	Author author;
+	std::vector<int> tags;
+	int fixed[3] = { 1, 2, 3 };
+	std::map<std::string, int> counts;
+	std::map<std::string, Author> people;
+	std::shared_ptr<Author> shared;
+	std::unique_ptr<Author> owned;
+	std::optional<Author> maybe;
+	std::any extra;
+	RPOCO2(&Doc::title, &Doc::version, &Doc::author, &Doc::tags, &Doc::fixed, &Doc::counts, &Doc::people,
+		&Doc::shared, &Doc::owned, &Doc::maybe, &Doc::extra);
+};
+
+using obj = std::map<std::string, std::any>;
+
+int main() {
+	{
+		Doc d;
+		CHECK(json::parse(d, R"({"title":"a","author":{"name":"x","age":40},"tags":[1,2,3],"counts":{"a":1,"b":2},"people":{"p":{"name":"p"}}})"));
+
+		// only members present in the patch change, objects merge recursively
+		CHECK(json::merge_patch(d, R"({"title":"b","author":{"age":41},"unknown":{"deep":[1]}})"));
+		CHECK(d.title == "b" && d.author.name == "x" && d.author.age == 41 && d.version == 1);
+
+		// arrays are replaced as a whole
+		CHECK(json::merge_patch(d, R"({"tags":[9]})"));
+		CHECK(d.tags.size() == 1 && d.tags[0] == 9);
+		CHECK(json::merge_patch(d, R"({"fixed":[7]})"));
+		CHECK(d.fixed[0] == 7 && d.fixed[1] == 0 && d.fixed[2] == 0);
+
+		// maps merge per key and null erases a key
+		CHECK(json::merge_patch(d, R"({"counts":{"a":null,"c":3},"people":{"p":{"age":5},"q":{"name":"q"}}})"));
+		CHECK(d.counts.size() == 2 && !d.counts.count("a") && d.counts["b"] == 2 && d.counts["c"] == 3);
+		CHECK(d.people["p"].name == "p" && d.people["p"].age == 5 && d.people["q"].name == "q" && d.people["q"].age == 30);
+
+		// null resets members to their defaults
+		CHECK(json::merge_patch(d, R"({"title":null,"author":null,"counts":null})"));
+		CHECK(d.title.empty() && d.author.name.empty() && d.author.age == 30 && d.counts.empty());
+	}
+	{
+		// pointers and optionals are created when patched and reset by null
+		Doc d;
+		CHECK(json::merge_patch(d, R"({"shared":{"name":"s"},"owned":{"age":1},"maybe":{"name":"m"}})"));
+		CHECK(d.shared && d.shared->name == "s" && d.shared->age == 30);
+		CHECK(d.owned && d.owned->age == 1);
+		CHECK(d.maybe && d.maybe->name == "m");
+		CHECK(json::merge_patch(d, R"({"maybe":{"age":2}})"));
+		CHECK(d.maybe->name == "m" && d.maybe->age == 2);
+
+		// shared objects seen by other owners are copied before they're patched
+		auto other = d.shared;
+		CHECK(json::merge_patch(d, R"({"shared":{"age":99}})"));
+		CHECK(d.shared->age == 99 && other->age == 30 && d.shared->name == "s");
+
+		CHECK(json::merge_patch(d, R"({"shared":null,"owned":null,"maybe":null})"));
+		CHECK(!d.shared && !d.owned && !d.maybe);
+	}
+	{
+		// dynamic values merge objects, a new object drops the nulls in the patch
+		Doc d;
+		CHECK(json::merge_patch(d, R"({"extra":{"a":1,"b":null,"c":{"d":null,"e":"x"}}})"));
+		auto& o = std::any_cast<obj&>(d.extra);
+		CHECK(o.size() == 2 && o.count("a") && !o.count("b"));
+		auto& c = std::any_cast<obj&>(o["c"]);
+		CHECK(c.size() == 1 && std::any_cast<std::string&>(c["e"]) == "x");
+		CHECK(json::merge_patch(d, R"({"extra":{"a":null,"f":[1]}})"));
+		auto& o2 = std::any_cast<obj&>(d.extra);
+		CHECK(!o2.count("a") && o2.count("c") && o2["f"].type() == typeid(std::vector<std::any>));
+		CHECK(json::merge_patch(d, R"({"extra":5})"));
+		CHECK(std::any_cast<double>(d.extra) == 5);
+	}
+	{
+		// a failed patch of a replaced value leaves it untouched
+		Doc d;
+		d.tags = { 1, 2 };
+		CHECK(!json::merge_patch(d, R"({"tags":[3,"x"]})"));
+		CHECK(d.tags.size() == 2 && d.tags[1] == 2);
+		CHECK(!json::merge_patch(d, R"({"author":[1]})"));
+	}
+	return CHECK_RESULT();
+}
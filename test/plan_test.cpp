@@ -0,0 +1,97 @@
+// json::parse_planned gives the same objects as json::parse
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_plan.hpp>
+#include <rpoco2/hash.hpp>
+
+#include <string>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Leaf {
+	int id = 7;
+	float weight = 0;
+	char tag[8] = "none";
+	RPOCO2(&Leaf::id, &Leaf::weight, &Leaf::tag);
+};
+
+// a recursive type, the vector elements go through the plan of Node itself
+struct Node {
+	std::string name;
+	std::vector<Node> children;
+	RPOCO2(&Node::name, &Node::children);
+};
+
+struct Root {
+	int count = 0;
+	double price = 0;
+	bool active = false;
+	char label[12] = {};
+	Leaf leaf;
+	std::vector<int> values;
+	std::vector<Leaf> leaves;
+	std::vector<std::vector<Leaf>> grid;
+	std::map<std::string, Leaf> by_name;
+	std::optional<Leaf> maybe;
+	std::shared_ptr<Leaf> shared;
+	std::unique_ptr<Leaf> owned;
+	Node tree;
+	RPOCO2(&Root::count, &Root::price, &Root::active, &Root::label, &Root::leaf, &Root::values, &Root::leaves, &Root::grid,
+		&Root::by_name, &Root::maybe, &Root::shared, &Root::owned, &Root::tree);
+};
+
+// the plan tables are constants
+static_assert(json::impl::plan_table<Root>::plan.count == 13);
+static_assert(json::impl::plan_table<Root>::members[4].kind == json::impl::plan_kind::object);
+static_assert(json::impl::plan_table<Root>::members[4].nested == &json::impl::plan_table<Leaf>::plan);
+static_assert(json::impl::plan_table<Leaf>::members[2].kind == json::impl::plan_kind::chars && json::impl::plan_table<Leaf>::members[2].size == 8);
+
+static bool both(Root& a, Root& b, const char* src) {
+	bool pa = json::parse(a, src);
+	bool pb = json::parse_planned(b, src);
+	CHECK(pa == pb);
+	return pa && pb;
+}
+
+int main() {
+	const char* docs[] = {
+		R"({})",
+		R"({"count":3,"price":-1.5e2,"active":true,"label":"hello","leaf":{"id":1,"weight":0.5,"tag":"t"}})",
+		R"({"values":[1,2,3],"leaves":[{"id":1},{"weight":2},{}],"grid":[[{"id":2}],[],[{"tag":"x"},{"id":3}]]})",
+		R"({"by_name":{"a":{"id":4},"b":{}},"maybe":{"id":5},"shared":{"tag":"s"},"owned":{"weight":1}})",
+		R"({"maybe":null,"shared":null,"owned":null,"unknown":{"skipped":[1,{"x":null}]},"count":9})",
+		R"({"tree":{"name":"root","children":[{"name":"a","children":[{"name":"a1"}]},{"name":"b","children":[]}]}})",
+	};
+	for (auto doc : docs) {
+		Root a, b;
+		CHECK(both(a, b, doc));
+		CHECK(equal(a.leaf, b.leaf) && equal(a.leaves, b.leaves) && equal(a.grid, b.grid) && equal(a.by_name, b.by_name));
+		CHECK(equal(a.maybe, b.maybe) && equal(a.shared, b.shared) && equal(a.owned, b.owned) && equal(a.tree, b.tree));
+		CHECK(a.count == b.count && a.price == b.price && a.active == b.active && std::string(a.label) == b.label && a.values == b.values);
+	}
+	{
+		Root r;
+		CHECK(json::parse_planned(r, R"({"leaves":[{"id":1},{}],"tree":{"children":[{"children":[{"name":"deep"}]}]},"maybe":{}})"));
+		CHECK(r.leaves.size() == 2 && r.leaves[0].id == 1 && r.leaves[1].id == 7 && std::string(r.leaves[1].tag) == "none");
+		CHECK(r.tree.children.size() == 1 && r.tree.children[0].children[0].name == "deep");
+		CHECK(r.maybe && r.maybe->id == 7);
+	}
+	{
+		// invalid documents fail in both
+		const char* bad[] = {
+			R"({"leaves":[{"id":"x"}]})",
+			R"({"label":"longer than twelve"})",
+			R"({"by_name":{"a":[]}})",
+			R"({"grid":[[{"id":1},]]})",
+			R"({"maybe":nul})",
+		};
+		for (auto doc : bad) {
+			Root a, b;
+			CHECK(!json::parse(a, doc));
+			CHECK(!json::parse_planned(b, doc));
+		}
+	}
+	return CHECK_RESULT();
+}
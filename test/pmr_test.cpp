@@ -0,0 +1,134 @@
+// parsing with a std::pmr::memory_resource
+
+#include <rpoco2/json_patch.hpp>
+
+#include <cstdlib>
+#include <new>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+// counts global heap allocations so the test can see that parsing with a resource doesn't use the heap
+static size_t heap_allocs = 0;
+void* operator new(size_t n) {
+	heap_allocs++;
+	if (void* p = malloc(n ? n : 1))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept {
+	free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+struct counting_resource : std::pmr::memory_resource {
+	size_t allocs = 0;
+	void* do_allocate(size_t bytes, size_t align) override {
+		allocs++;
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+	void do_deallocate(void* p, size_t bytes, size_t align) override {
+		std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+		return this == &o;
+	}
+};
+
+struct Defaults {
+	std::pmr::string s = "default";
+	std::pmr::vector<int> v = { 1, 2 };
+	std::pmr::map<std::pmr::string, int> m = { { "default", 1 } };
+	RPOCO2(&Defaults::s, &Defaults::v, &Defaults::m);
+};
+
+struct Inner {
+	std::pmr::string text;
+	RPOCO2(&Inner::text);
+};
+
+struct Doc {
+	std::pmr::string name;
+	std::pmr::vector<std::pmr::string> tags;
+	std::pmr::map<std::pmr::string, int> counts;
+	std::pmr::vector<Inner> inner;
+	std::shared_ptr<Inner> shared;
+	std::any dynamic;
+	RPOCO2(&Doc::name, &Doc::tags, &Doc::counts, &Doc::inner, &Doc::shared, &Doc::dynamic);
+};
+
+int main() {
+	const char* src = R"({"name":"a name longer than any small string buffer","tags":["first tag that is long enough to allocate","second tag that is long enough to allocate"],)"
+		R"("counts":{"a key long enough to allocate its own storage":1,"b":2},"inner":[{"text":"inner text that is long enough to allocate"}],"shared":{"text":"x"}})";
+	{
+		counting_resource res;
+		Doc d;
+		size_t before = heap_allocs;
+		CHECK(json::parse(d, src, -1, &res));
+		CHECK(heap_allocs == before);
+		CHECK(res.allocs > 0);
+		CHECK(d.name.get_allocator().resource() == &res);
+		CHECK(d.tags.size() == 2 && d.tags[1].get_allocator().resource() == &res);
+		CHECK(d.counts.size() == 2 && d.counts.begin()->first.get_allocator().resource() == &res);
+		CHECK(d.inner.size() == 1 && d.inner[0].text.get_allocator().resource() == &res);
+		CHECK(d.shared && d.shared->text == "x" && d.shared->text.get_allocator().resource() == &res);
+	}
+	{
+		// members with non-empty defaults are cleared and then moved onto the resource
+		counting_resource res;
+		Defaults d;
+		CHECK(json::parse(d, R"({"s":"a string long enough to need its own storage","v":[3]})", -1, &res));
+		CHECK(d.s.get_allocator().resource() == &res && d.s == "a string long enough to need its own storage");
+		CHECK(d.v.get_allocator().resource() == &res && d.v.size() == 1);
+		CHECK(d.m.get_allocator().resource() == std::pmr::get_default_resource());
+		CHECK(json::parse(d, R"({"m":{"a key long enough to need its own storage":2}})", -1, &res));
+		CHECK(d.m.get_allocator().resource() == &res && d.m.size() == 1 && !d.m.count("default"));
+		CHECK(d.m.begin()->first.get_allocator().resource() == &res);
+	}
+	{
+		// without a resource everything stays on the default resource
+		Doc d;
+		CHECK(json::parse(d, src));
+		CHECK(d.name.get_allocator().resource() == std::pmr::get_default_resource());
+		CHECK(d.tags[0] == "first tag that is long enough to allocate");
+		CHECK(d.counts["b"] == 2);
+	}
+	{
+		// std::any builds the same dom with or without a resource
+		counting_resource res;
+		Doc d;
+		CHECK(json::parse(d, R"({"dynamic":{"list":[1,"two"],"s":"str"}})", -1, &res));
+		using obj = std::map<std::string, std::any>;
+		CHECK(d.dynamic.type() == typeid(obj));
+		auto& o = std::any_cast<obj&>(d.dynamic);
+		CHECK(o["list"].type() == typeid(std::vector<std::any>) && o["s"].type() == typeid(std::string));
+		CHECK(std::any_cast<std::string&>(o["s"]) == "str");
+	}
+	{
+		// opting in builds the std::any dom from pmr containers on the resource
+		counting_resource res;
+		json::parse_options options;
+		options.resource = &res;
+		options.pmr_dom = true;
+		Doc d;
+		CHECK(json::parse(d, R"({"dynamic":{"list":[1,"a string long enough to need its own storage"],"s":"str"}})", -1, options));
+		using obj = std::pmr::map<std::pmr::string, std::any>;
+		CHECK(d.dynamic.type() == typeid(obj));
+		auto& o = std::any_cast<obj&>(d.dynamic);
+		CHECK(o.get_allocator().resource() == &res);
+		auto& list = std::any_cast<std::pmr::vector<std::any>&>(o["list"]);
+		CHECK(list.get_allocator().resource() == &res && std::any_cast<double>(list[0]) == 1);
+		auto& s = std::any_cast<std::pmr::string&>(list[1]);
+		CHECK(s == "a string long enough to need its own storage" && s.get_allocator().resource() == &res);
+
+		// patches keep merging into the pmr dom
+		CHECK(json::merge_patch(d, R"({"dynamic":{"s":null,"n":{"x":true}}})", -1, options));
+		auto& po = std::any_cast<obj&>(d.dynamic);
+		CHECK(!po.count("s") && po.count("list"));
+		CHECK(std::any_cast<obj&>(po["n"]).get_allocator().resource() == &res);
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,121 @@
+// JSON pointers compiled against types
+
+#include <rpoco2/json_std.hpp>
+#include <rpoco2/json_fixed.hpp>
+#include <rpoco2/json_pointer.hpp>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Item {
+	int price = 0;
+	char sku[8] = {};
+	RPOCO2(&Item::price, &Item::sku);
+};
+
+struct Order {
+	int id = 0;
+	Item first;
+	Item slots[2];
+	std::array<int, 3> codes{};
+	std::vector<Item> items;
+	std::map<std::string, Item> by_sku;
+	std::pmr::map<std::pmr::string, int> pmr_counts;
+	std::shared_ptr<Item> shared;
+	std::unique_ptr<Item> owned;
+	std::optional<Item> maybe;
+	fixed_vector<Item, 4> few;
+	RPOCO2(&Order::id, &Order::first, &Order::slots, &Order::codes, &Order::items, &Order::by_sku,
+		&Order::pmr_counts, &Order::shared, &Order::owned, &Order::maybe, &Order::few);
+};
+
+// not standard layout, members go through access steps instead of offsets
+struct Wrapper {
+	virtual ~Wrapper() = default;
+	std::string name;
+	Order order;
+	std::vector<bool> flags;
+	RPOCO2(&Wrapper::name, &Wrapper::order, &Wrapper::flags);
+};
+
+template<class V, class T>
+static V* at(T& obj, const char* path) {
+	json::pointer<T> p(path);
+	return p ? p.template get<V>(obj) : nullptr;
+}
+
+int main() {
+	Order o;
+	CHECK(json::parse(o, R"({"id":1,"first":{"price":2},"slots":[{"price":3},{"price":4}],"codes":[5,6,7],
+		"items":[{"price":8},{"price":9,"sku":"a/b~c"}],"by_sku":{"a/b":{"price":10}},"pmr_counts":{"x":11},
+		"shared":{"price":12},"owned":{"price":13},"maybe":{"price":14},"few":[{"price":15}]})"));
+
+	CHECK(at<Order>(o, "") == &o);
+	CHECK(at<int>(o, "/id") == &o.id);
+	CHECK(at<int>(o, "/first/price") == &o.first.price);
+	CHECK(at<int>(o, "/slots/1/price") == &o.slots[1].price);
+	CHECK(at<int>(o, "/codes/2") == &o.codes[2]);
+	CHECK(at<int>(o, "/items/1/price") == &o.items[1].price);
+	CHECK(at<int>(o, "/by_sku/a~1b/price") == &o.by_sku["a/b"].price);
+	CHECK(at<int>(o, "/pmr_counts/x") && *at<int>(o, "/pmr_counts/x") == 11);
+	CHECK(at<int>(o, "/shared/price") == &o.shared->price);
+	CHECK(at<int>(o, "/owned/price") == &o.owned->price);
+	CHECK(at<int>(o, "/maybe/price") == &o.maybe->price);
+	CHECK(at<int>(o, "/few/0/price") == &o.few[0].price);
+	CHECK(at<std::optional<Item>>(o, "/maybe") == &o.maybe);
+
+	// paths that can't refer to anything in the type don't compile
+	CHECK(!json::pointer<Order>("/nope"));
+	CHECK(!json::pointer<Order>("/slots/2"));
+	CHECK(!json::pointer<Order>("/codes/01"));
+	CHECK(!json::pointer<Order>("/few/4"));
+	CHECK(!json::pointer<Order>("id"));
+	CHECK(!json::pointer<Order>("/id/x"));
+	CHECK(!json::pointer<Order>("/items/18446744073709551617"));
+	CHECK(!json::pointer<Order>("/items/99999999999999999999999/price"));
+
+	// paths that compile but are absent in this object
+	CHECK(at<int>(o, "/items/2/price") == nullptr);
+	CHECK(at<int>(o, "/by_sku/zzz/price") == nullptr);
+	CHECK(at<int>(o, "/pmr_counts/y") == nullptr);
+	CHECK(at<int>(o, "/few/1/price") == nullptr);
+	o.shared.reset();
+	o.owned.reset();
+	o.maybe.reset();
+	CHECK(at<int>(o, "/shared/price") == nullptr);
+	CHECK(at<int>(o, "/owned/price") == nullptr);
+	CHECK(at<int>(o, "/maybe/price") == nullptr);
+
+	// wrong value types give null, set writes through
+	CHECK(at<double>(o, "/id") == nullptr);
+	json::pointer<Order> p("/items/0/price");
+	CHECK(p.type() == typeid(int));
+	CHECK(p.set(o, 99) && o.items[0].price == 99);
+	CHECK(p.eval(o).get<int>() == &o.items[0].price);
+
+	// set converts numbers between arithmetic types and strings to string and char array members
+	CHECK(p.set(o, 12.0) && o.items[0].price == 12);
+	CHECK(json::pointer<Order>("/items/1/sku").set(o, "xy") && std::string(o.items[1].sku) == "xy");
+	CHECK(!json::pointer<Order>("/items/1/sku").set(o, "longer than eight"));
+	CHECK(!p.set(o, "12") && o.items[0].price == 12);
+	CHECK(!json::pointer<Order>("/items/5/price").set(o, 1));
+
+	std::vector<Order> batch(3);
+	batch[1].id = 5;
+	std::vector<int*> ids;
+	CHECK(json::pointer<Order>("/id").get_all(batch, ids) && ids.size() == 3 && *ids[1] == 5);
+
+	Wrapper w;
+	w.order.first.price = 21;
+	CHECK(at<int>(w, "/order/first/price") == &w.order.first.price);
+	CHECK(at<std::string>(w, "/name") == &w.name);
+	CHECK(json::pointer<Wrapper>("/name").set(w, "x") && w.name == "x");
+	CHECK(json::pointer<Wrapper>("/name").set(w, std::string_view("y")) && w.name == "y");
+	CHECK(json::pointer<Wrapper>("/order/codes/1").set(w, 'a') && w.order.codes[1] == 'a');
+
+	// vector<bool> elements aren't addressable, the pointer can only end at the vector
+	CHECK(at<std::vector<bool>>(w, "/flags") == &w.flags);
+	CHECK(!json::pointer<Wrapper>("/flags/0"));
+	return CHECK_RESULT();
+}
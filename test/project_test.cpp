@@ -0,0 +1,53 @@
+// parsing and visiting through member projections
+
+#include <rpoco2/json_project.hpp>
+#include <rpoco2/json_std_string.hpp>
+#include <rpoco2/json_std_vector.hpp>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Item {
+	int id = 0;
+	std::string name;
+	std::vector<int> values;
+	double price = 0;
+	RPOCO2(&Item::id, &Item::name, &Item::values, &Item::price);
+};
+
+int main() {
+	const char* src = R"({"id":7,"name":"widget","values":[1,2,3],"price":2.5,"extra":{"a":[true]}})";
+
+	{
+		// members outside the projection are skipped and left as they are
+		Item it;
+		it.name = "keep";
+		project<Item, &Item::price, &Item::id> p{ it };
+		CHECK(json::parse(p, src));
+		CHECK(it.id == 7 && it.price == 2.5 && it.name == "keep" && it.values.empty());
+
+		// names and order follow the projection, not the declaration
+		std::string names;
+		int sum = 0;
+		p.foreach([&](const auto& name, auto& v) {
+			names += std::string(name) + ";";
+			if constexpr (std::is_arithmetic_v<std::remove_reference_t<decltype(v)>>)
+				sum += (int)v;
+		});
+		CHECK(names == "price;id;");
+		CHECK(sum == 9);
+		CHECK(p.type_info()->find("id", 2) >= 0 && p.type_info()->find("name", 4) < 0);
+	}
+	{
+		Item it;
+		project<Item, &Item::values> p{ it };
+		CHECK(json::parse(p, src));
+		CHECK(it.values.size() == 3 && it.id == 0 && it.name.empty());
+
+		// skipped members are still validated
+		CHECK(!json::parse(p, R"({"name":[1,}, "values":[4]})"));
+		CHECK(!json::parse(p, R"({"values":["x"]})"));
+	}
+	return CHECK_RESULT();
+}
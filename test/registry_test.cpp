@@ -0,0 +1,107 @@
+// member descriptors and the type registry
+
+#include <rpoco2/project.hpp>
+#include <rpoco2/registry.hpp>
+
+#include <cstddef>
+#include <string>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+struct Vec {
+	float x = 0, y = 0;
+	RPOCO2(&Vec::x, &Vec::y);
+};
+
+struct Unit {
+	struct tag {};
+	char name[16] = {};
+	int hp = 0;
+	Vec pos;
+	std::string note;
+	RPOCO2(&Unit::name, &Unit::pos, &Unit::note, opt{ &Unit::hp, tag{} });
+};
+
+// not standard layout, members are still reached through their member pointers
+struct Derived {
+	virtual ~Derived() = default;
+	int a = 1;
+	double b = 2;
+	RPOCO2(&Derived::a, &Derived::b);
+};
+
+RPOCO2_REGISTER(Vec);
+RPOCO2_REGISTER(Unit);
+RPOCO2_REGISTER(Derived);
+
+// the descriptor tables are constants
+static_assert(impl2::member_descs<Unit>.size() == 4);
+static_assert(impl2::member_descs<Unit>[3].name == "hp" && impl2::member_descs<Unit>[3].kind == member_kind::signed_int);
+static_assert(impl2::member_descs<Unit>[0].kind == member_kind::chars && impl2::member_descs<Unit>[0].size == 16);
+static_assert(impl2::member_descs<Unit>[1].nested == &impl2::tinfo<Vec>);
+
+int main() {
+	{
+		const type_info* ti = type_registry::global().find("Unit");
+		CHECK(ti && ti == Unit::rpoco2_type_info_get());
+		CHECK(type_registry::global().find("Missing") == nullptr);
+		CHECK(ti->type() == typeid(Unit) && ti->type_size() == sizeof(Unit));
+		CHECK(ti->member_count() == 4);
+		CHECK(ti->find_member("note") == 2 && ti->find_member("nope") == -1);
+
+		// standard layout members are reached by their cached offsets
+		static_assert(std::is_standard_layout_v<Unit>);
+		CHECK(ti->member_at(3).offset == offsetof(Unit, hp) && ti->member_at(1).offset == offsetof(Unit, pos));
+
+		auto& hp = ti->member_at(3);
+		CHECK(hp.name == "hp" && *hp.type == typeid(int) && hp.trivial);
+		CHECK(hp.has_option(typeid(Unit::tag)) && !hp.has_option(typeid(int)));
+		auto& pos = ti->member_at(1);
+		CHECK(pos.kind == member_kind::object && pos.nested == Vec::rpoco2_type_info_get());
+		CHECK(!ti->member_at(2).trivial && ti->member_at(2).kind == member_kind::other);
+
+		Unit u;
+		*ti->get_ptr<int>(&u, 3) = 42;
+		CHECK(u.hp == 42);
+		CHECK(ti->get_ptr<double>(&u, 3) == nullptr);
+		CHECK(ti->member_ptr(&u, 2) == &u.note);
+		const Unit& cu = u;
+		CHECK(ti->get_ptr<std::string>(&cu, 2) == &u.note);
+
+		// walk into a nested member through the nested type-info
+		auto* v = static_cast<Vec*>(ti->member_ptr(&u, 1));
+		*pos.nested->get_ptr<float>(v, pos.nested->find_member("y")) = 3;
+		CHECK(u.pos.y == 3);
+	}
+	{
+		const type_info* ti = type_registry::global().find("Derived");
+		CHECK(ti);
+		Derived d;
+		CHECK(ti->member_at(0).offset == member_desc::npos && ti->member_at(1).offset == member_desc::npos);
+		CHECK(ti->member_ptr(&d, 0) == &d.a && ti->member_ptr(&d, 1) == &d.b);
+		*ti->get_ptr<double>(&d, 1) = 5;
+		CHECK(d.b == 5);
+	}
+	{
+		// a projection describes its own members, in projection order
+		Unit u;
+		const type_info* ti = project<Unit, &Unit::hp, &Unit::name>::type_info();
+		CHECK(ti->member_count() == 2);
+		CHECK(ti->member_name(0) == "hp" && ti->member_at(0).name == "hp");
+		CHECK(ti->member_at(1).name == "name" && ti->member_at(1).kind == member_kind::chars);
+		CHECK(ti->get_ptr<int>(&u, 0) == &u.hp);
+		CHECK(ti->member_ptr(&u, 1) == &u.name);
+		CHECK(ti->member_at(0).has_option(typeid(Unit::tag)));
+		CHECK(ti->member_at(1).offset == offsetof(Unit, name));
+	}
+	{
+		int seen = 0;
+		type_registry::global().foreach([&seen](std::string_view name, const type_info*) {
+			seen += name == "Vec" || name == "Unit" || name == "Derived";
+		});
+		CHECK(seen == 3);
+	}
+	return CHECK_RESULT();
+}
@@ -0,0 +1,167 @@
+// validate and minify (the block scan where SSE2 is available) against the byte-at-a-time scan_document
+
+#include <rpoco2/json_validate.hpp>
+
+#include <random>
+#include <string>
+
+#include "check.hpp"
+
+using namespace rpoco2;
+
+static const json::utf8_mode modes[] = { json::utf8_mode::reject, json::utf8_mode::replace, json::utf8_mode::pass };
+
+// same error, offset and output as scan_document in every utf8 mode, returns if the document was valid
+static bool same(const std::string& doc) {
+	bool valid = false;
+	for (auto mode : modes) {
+		std::string expect;
+		auto sink = [&expect](const char* p, size_t n) {
+			expect.append(p, n);
+		};
+		json::validate_result want = json::impl::scan_document(doc.data(), doc.size(), mode, sink);
+
+		json::validate_result got = json::validate(doc.data(), doc.size(), json::parse_options{ mode });
+		std::string out;
+		json::validate_result mgot = json::minify(doc.data(), doc.size(), out, json::parse_options{ mode });
+		bool ok = got.code == want.code && got.offset == want.offset
+			&& mgot.code == want.code && mgot.offset == want.offset && out == expect;
+		CHECK(ok);
+		if (!ok)
+			printf("  mode %d, %zu bytes: expected error %d at %zu, validate %d at %zu, minify %d at %zu\n", (int)mode, doc.size(),
+				(int)want.code, want.offset, (int)got.code, got.offset, (int)mgot.code, mgot.offset);
+#if RPOCO2_SSE2
+		// valid documents should never need the fallback
+		if (want) {
+			std::string fast;
+			auto fsink = [&fast](const char* p, size_t n) {
+				fast.append(p, n);
+			};
+			const char* run = doc.data();
+			CHECK(json::impl::scan_structural<true>(doc.data(), doc.size(), mode, fsink, run) && fast == expect);
+		}
+#endif
+		valid = bool(want);
+	}
+	return valid;
+}
+
+// pads the document so that the token after the prefix starts at pos
+static std::string at(size_t pos, const std::string& prefix, const std::string& rest) {
+	std::string doc = "[" + std::string(pos > prefix.size() + 1 ? pos - prefix.size() - 1 : 0, ' ') + prefix;
+	return doc + rest;
+}
+
+int main() {
+	// small documents of every kind
+	const char* docs[] = {
+		"", " ", "0", "-0", "01", "-", "1.", "1.5e", "1e+5", "-12.5E-3", "123456789012345678901234567890",
+		"true", "false", "null", "tru", "nul", "truex", "nullnull", "true false", "1 2",
+		"\"\"", "\"abc\"", "\"a\\\"b\"", "\"\\\\\"", "\"\\u00e9\\ud83d\\ude00\"", "\"\\ud83d\"", "\"\\ude00\"", "\"\\x\"", "\"\\u12g4\"",
+		"\"a\tb\"", "\"a\nb\"", "\"unterminated", "\"\\",
+		"[]", "{}", "[1,2,3]", "[1,,2]", "[1,]", "[,1]", "[1 2]", "{\"a\":1}", "{\"a\" : 1 , \"b\" : [ true , null ] }",
+		"{\"a\"}", "{\"a\":}", "{1:2}", "{\"a\":1,}", "{,}", "[}", "{]", "[[[]]]", "[[[]]", "]", "}", ",", ":",
+		"{\"a\":1}x", "[] []", "  [1]  \n", "[1]\t\r\n ", "[\x01]", "[1\x7f]", "[\"caf\xc3\xa9\"]", "[\xc3\xa9]",
+		"{\"k\":\"v\",\"n\":{\"m\":[1,-2.5,3e4,\"s\",{\"d\":null}]}}",
+	};
+	for (const char* d : docs)
+		same(d);
+
+	// invalid utf-8 inside strings, alone and ending exactly at block boundaries
+	const char* seqs[] = {
+		"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf", "\xef\xbf\xbd",
+		"\xc0\x80", "\xc1\xbf", "\xe0\x80\x80", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xed\xbf\xbf", "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf",
+		"\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\x80", "\xbf\xbf", "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\xc3\xc3\xa9", "\xe2\x28\xa1",
+	};
+	for (const char* s : seqs) {
+		same(std::string("\"") + s + "\"");
+		same(std::string("\"") + s);
+		for (size_t pos = 56; pos < 72; pos++) {
+			same(at(pos, "\"", std::string(s) + "\"]"));
+			same(at(pos, "\"ab", std::string(s) + "\"]"));
+		}
+		for (size_t pos = 4090; pos < 4100; pos++)
+			same(at(pos, "\"", std::string(s) + "\"]"));
+	}
+
+	// escapes, quotes and tokens straddling 64 byte blocks
+	const char* tokens[] = {
+		"\"\\\\\"", "\"\\\"\"", "\"\\\\\\\"\"", "\"\\u00e9\"", "\"\\ud83d\\ude00\"", "\"\\ud83d\"", "\"\\\\\\\\\\\\\\\\\\\\\"",
+		"\"\\x\"", "\"\t\"", "1234", "-0.5", "01", "0", "true", "null", "falsy", "\"\"", "{}", "[]", "{\"a\":1}",
+	};
+	for (const char* t : tokens) {
+		for (size_t pos = 50; pos < 80; pos++) {
+			same(at(pos, "", std::string(t) + "]"));
+			same(at(pos, "", std::string(t) + " ]"));
+			same(at(pos, "[0,", std::string(t) + "]]"));
+			same(at(pos, "", t));
+		}
+	}
+
+	// whitespace runs crossing chunks
+	for (size_t pos = 4080; pos < 4110; pos++) {
+		same(at(pos, "1,", " , 2]"));
+		same(at(pos, "1,", std::string(300, ' ') + "2]"));
+		same(at(pos, "", std::string(5000, ' ') + "1]"));
+	}
+
+	// deep nesting, the stack moves out of its inline words past 256 levels
+	for (size_t depth : { 255, 256, 257, 1000 }) {
+		CHECK(same(std::string(depth, '[') + std::string(depth, ']')));
+		CHECK(!same(std::string(depth, '[') + std::string(depth - 1, ']')));
+		std::string objs;
+		for (size_t i = 0; i < depth; i++)
+			objs += "{\"k\":";
+		objs += "1" + std::string(depth, '}');
+		CHECK(same(objs));
+		objs.back() = ']';
+		CHECK(!same(objs));
+	}
+
+	// larger documents mixing everything, then random mutations of them
+	std::mt19937 rng(1234);
+	auto pick = [&rng](size_t n) {
+		return size_t(rng() % n);
+	};
+	const char* values[] = { "1234", "-0.25", "1e3", "0", "true", "false", "null", "\"text\"", "\"esc \\\" \\\\ \\n\"",
+		"\"\\u00e9\\ud83d\\ude00\"", "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"", "[]", "{}" };
+	const char* spaces[] = { "", "", " ", "\n  ", "\t", "\r\n" };
+	std::vector<std::string> large;
+	for (int n = 0; n < 8; n++) {
+		std::string doc = "[";
+		size_t items = 50 + pick(1500);
+		for (size_t i = 0; i < items; i++) {
+			if (i)
+				doc += std::string(spaces[pick(6)]) + "," + spaces[pick(6)];
+			if (pick(4) == 0)
+				doc += std::string("{") + spaces[pick(6)] + "\"key\"" + spaces[pick(6)] + ":" + spaces[pick(6)] + values[pick(13)] + "}";
+			else
+				doc += values[pick(13)];
+		}
+		doc += "]";
+		CHECK(same(doc));
+		large.push_back(doc);
+	}
+	const char bytes[] = { ' ', '\"', '\\', ',', ':', '[', ']', '{', '}', '0', '1', '-', 'e', 'n', '\t', '\n', '\x01', '\x80', '\xc3', '\xed', '\xf4', '\xff' };
+	for (int i = 0; i < 600; i++) {
+		std::string doc = large[pick(large.size())];
+		for (size_t m = 1 + pick(3); m; m--) {
+			size_t pos = pick(doc.size());
+			switch (pick(3)) {
+			case 0:
+				doc[pos] = bytes[pick(sizeof(bytes))];
+				break;
+			case 1:
+				doc.erase(pos, 1 + pick(4));
+				break;
+			default:
+				doc.insert(pos, 1, bytes[pick(sizeof(bytes))]);
+				break;
+			}
+		}
+		same(doc);
+		same(doc.substr(0, pick(doc.size())));
+	}
+
+	return CHECK_RESULT();
+}